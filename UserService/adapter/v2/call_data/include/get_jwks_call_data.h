@@ -0,0 +1,22 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#pragma once
+#include "adapter/v2/call_data/interface/call_data.hpp"
+#include <UserService/v1/user_service.grpc.pb.h>
+
+namespace user_service::adapter::v2 {
+    class GetJwksCallDataManager;
+
+    class GetJwksCallData final: public CallData<proto::v1::GetJwksRequest, google::api::HttpBody, GetJwksCallDataManager, GetJwksCallData> {
+        friend GetJwksCallDataManager;
+    public:
+        static constexpr bool kRequiresAuth = false;
+        // 只读内存中的 JWKS，没有 I/O，就地完成
+        static constexpr bool kStartInline = true;
+
+        GetJwksCallData(GetJwksCallDataManager* manager, size_t shard_index);
+        ~GetJwksCallData() override;
+        boost::asio::awaitable<void> RunSpecificLogic([[maybe_unused]] std::string user_id);
+    };
+}
@@ -12,8 +12,10 @@ namespace user_service::adapter::v2 {
         friend GetUserInfoCallDataManager;
     public:
         static constexpr bool kRequiresAuth = true;
+        // 热点读接口：首个 await 即是 Redis 访问，就地启动省去一次线程切换
+        static constexpr bool kStartInline = true;
 
-        explicit GetUserInfoCallData(GetUserInfoCallDataManager* manager);
+        GetUserInfoCallData(GetUserInfoCallDataManager* manager, size_t shard_index);
         ~GetUserInfoCallData() override;
         boost::asio::awaitable<void> RunSpecificLogic(std::string user_id);
     };
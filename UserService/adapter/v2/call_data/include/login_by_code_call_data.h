@@ -12,8 +12,9 @@ namespace user_service::adapter::v2 {
         friend LoginByCodeCallDataManager;
     public:
         static constexpr bool kRequiresAuth = false;
+        static constexpr bool kStartInline = false;
 
-        explicit LoginByCodeCallData(LoginByCodeCallDataManager* manager);
+        LoginByCodeCallData(LoginByCodeCallDataManager* manager, size_t shard_index);
         ~LoginByCodeCallData() override;
         boost::asio::awaitable<void> RunSpecificLogic([[maybe_unused]] std::string user_id);
     };
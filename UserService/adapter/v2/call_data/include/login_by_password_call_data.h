@@ -12,8 +12,9 @@ namespace user_service::adapter::v2 {
         friend LoginByPasswordCallDataManager;
     public:
         static constexpr bool kRequiresAuth = false;
+        static constexpr bool kStartInline = false;
 
-        explicit LoginByPasswordCallData(LoginByPasswordCallDataManager* manager);
+        LoginByPasswordCallData(LoginByPasswordCallDataManager* manager, size_t shard_index);
         ~LoginByPasswordCallData() override;
         boost::asio::awaitable<void> RunSpecificLogic([[maybe_unused]] std::string user_id);
     };
@@ -11,8 +11,9 @@ namespace user_service::adapter::v2 {
         friend RegisterCallDataManager;
     public:
         static constexpr bool kRequiresAuth = false;
+        static constexpr bool kStartInline = false;
 
-        explicit RegisterCallData(RegisterCallDataManager* manager);
+        RegisterCallData(RegisterCallDataManager* manager, size_t shard_index);
         ~RegisterCallData() override;
         boost::asio::awaitable<void> RunSpecificLogic([[maybe_unused]] std::string user_id);
     };
@@ -11,8 +11,9 @@ namespace user_service::adapter::v2 {
         friend SendCodeCallDataManager;
     public:
         static constexpr bool kRequiresAuth = false;
+        static constexpr bool kStartInline = false;
 
-        explicit SendCodeCallData(SendCodeCallDataManager* manager);
+        SendCodeCallData(SendCodeCallDataManager* manager, size_t shard_index);
         ~SendCodeCallData() override;
         boost::asio::awaitable<void> RunSpecificLogic([[maybe_unused]] std::string user_id);
     };
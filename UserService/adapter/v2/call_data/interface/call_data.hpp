@@ -4,9 +4,11 @@
 #pragma once
 #include "adapter/v2/call_data/interface/i_call_data.h"
 #include "adapter/v2/call_data_manager/interface/call_data_manager.hpp"
+#include "infrastructure/asio_thread_pool/inline_start_executor.h"
 #include <boost/asio/co_spawn.hpp>
 #include <spdlog/spdlog.h>
 #include <grpcpp/grpcpp.h>
+#include <atomic>
 #include <expected>
 #include <utility>
 
@@ -30,7 +32,8 @@ namespace user_service::adapter::v2 {
     template<typename RequestType, typename ResponseType, typename ManagerType, typename SpecificCallDataType>
     class CallData : public ICallData {
     public:
-        explicit CallData(ManagerType* manager) : status_(State::WAIT_PROCESSING), manager_(manager), responder_(&ctx_) {
+        CallData(ManagerType* manager, const size_t shard_index) : status_(State::WAIT_PROCESSING), manager_(manager),
+            shard_index_(shard_index), responder_(&ctx_) {
             static_assert(std::is_base_of_v<ICallDataManager, ManagerType>, "ManagerType must derive from ICallDataManager");
         }
 
@@ -88,7 +91,20 @@ namespace user_service::adapter::v2 {
             status_ = State::FINISHED;
             SPDLOG_DEBUG("start register coroutine");
 
-            boost::asio::co_spawn(manager_->GetIOContext(),
+            // 3. 启动协程 (编译期选择启动方式)
+            if constexpr (SpecificCallDataType::kStartInline) {
+                // 就地启动：只有启动这一步在当前 CQ 线程上执行，挂起后的恢复都交给 io_context
+                inline_start_pending_.store(true, std::memory_order_release);
+                SpawnLogic(infrastructure::InlineStartExecutor(manager_->GetIOContext().get_executor(), &inline_start_pending_),
+                           std::move(user_id));
+            } else {
+                SpawnLogic(manager_->GetIOContext().get_executor(), std::move(user_id));
+            }
+        }
+
+        template<typename Executor>
+        void SpawnLogic(const Executor& executor, std::string user_id) {
+            boost::asio::co_spawn(executor,
                                     // 参数2: 业务逻辑
                                   [this, uid = std::move(user_id)] mutable {
                                       return RunLogic(std::move(uid));
@@ -176,6 +192,8 @@ namespace user_service::adapter::v2 {
         // 仅内部使用，call data manager 友元可访问，但不该访问
         enum class State { WAIT_PROCESSING, FINISHED };
         State status_;
+        // InlineStartExecutor 的一次性就地执行标志，CallData 比协程活得久
+        std::atomic<bool> inline_start_pending_{false};
 
     // 供 call data 子类使用，此处需要设置为 protected
     protected:
@@ -189,7 +207,12 @@ namespace user_service::adapter::v2 {
         grpc::ServerAsyncResponseWriter<ResponseType>* GetResponderAddress() {
             return &responder_;
         }
+        // 当前 CallData 所属的 CQ 分片
+        [[nodiscard]] size_t GetShardIndex() const {
+            return shard_index_;
+        }
         ManagerType* manager_;
+        const size_t shard_index_;
         RequestType request_;
         ResponseType reply_;
         grpc::ServerContext ctx_;
@@ -0,0 +1,20 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#include "adapter/v2/call_data/include/get_jwks_call_data.h"
+#include "adapter/v2/call_data_manager/include/get_jwks_call_data_manager.h"
+
+using namespace user_service::adapter::v2;
+
+GetJwksCallData::GetJwksCallData(GetJwksCallDataManager* manager, const size_t shard_index): CallData(manager, shard_index) {
+
+}
+
+GetJwksCallData::~GetJwksCallData() = default;
+
+boost::asio::awaitable<void> GetJwksCallData::RunSpecificLogic(std::string user_id) {
+    // 网关转码后原样作为 HTTP 响应体返回
+    reply_.set_content_type("application/json");
+    reply_.set_data(manager_->GetJwtUtil()->GetJwks());
+    co_return;
+}
@@ -7,7 +7,7 @@
 
 using namespace user_service::adapter::v2;
 
-GetUserInfoCallData::GetUserInfoCallData(GetUserInfoCallDataManager* manager): CallData(manager) {
+GetUserInfoCallData::GetUserInfoCallData(GetUserInfoCallDataManager* manager, const size_t shard_index): CallData(manager, shard_index) {
 
 }
 
@@ -7,7 +7,7 @@
 
 using namespace user_service::adapter::v2;
 
-LoginByCodeCallData::LoginByCodeCallData(LoginByCodeCallDataManager* manager): CallData(manager) {
+LoginByCodeCallData::LoginByCodeCallData(LoginByCodeCallDataManager* manager, const size_t shard_index): CallData(manager, shard_index) {
 
 }
 
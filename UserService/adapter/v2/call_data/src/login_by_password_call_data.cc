@@ -7,7 +7,7 @@
 
 using namespace user_service::adapter::v2;
 
-LoginByPasswordCallData::LoginByPasswordCallData(LoginByPasswordCallDataManager* manager): CallData(manager) {
+LoginByPasswordCallData::LoginByPasswordCallData(LoginByPasswordCallDataManager* manager, const size_t shard_index): CallData(manager, shard_index) {
 
 }
 
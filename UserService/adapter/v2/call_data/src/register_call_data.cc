@@ -8,7 +8,7 @@
 using namespace user_service::adapter::v2;
 
 
-RegisterCallData::RegisterCallData(RegisterCallDataManager* manager): CallData(manager) {
+RegisterCallData::RegisterCallData(RegisterCallDataManager* manager, const size_t shard_index): CallData(manager, shard_index) {
 
 }
 
@@ -9,7 +9,7 @@
 using namespace user_service::adapter::v2;
 
 
-SendCodeCallData::SendCodeCallData(SendCodeCallDataManager* manager): CallData(manager) {
+SendCodeCallData::SendCodeCallData(SendCodeCallDataManager* manager, const size_t shard_index): CallData(manager, shard_index) {
 
 }
 
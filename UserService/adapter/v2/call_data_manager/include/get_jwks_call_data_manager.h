@@ -0,0 +1,21 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#pragma once
+#include "adapter/v2/call_data_manager/interface/call_data_manager.hpp"
+#include "service/interface/i_auth_service.h"
+
+namespace user_service::adapter::v2 {
+    class GetJwksCallData;
+    class GetJwksCallDataManager final: public CallDataManager<proto::v1::AuthService::AsyncService, GetJwksCallData, service::IAuthService, GetJwksCallDataManager> {
+        friend GetJwksCallData;
+    public:
+        GetJwksCallDataManager(size_t initial_size, proto::v1::AuthService::AsyncService* grpc_service,
+            service::IAuthService* business_service, util::IJwtUtil* jwt_util,
+            const std::vector<std::shared_ptr<boost::asio::io_context>>& iocs, const std::vector<grpc::ServerCompletionQueue*>& cqs);
+
+        ~GetJwksCallDataManager() override;
+
+        void SpecificRegisterCallDataToCQ(GetJwksCallData* call_data) const;
+    };
+}
@@ -13,7 +13,7 @@ namespace user_service::adapter::v2 {
     public:
         LoginByCodeCallDataManager(size_t initial_size, proto::v1::AuthService::AsyncService* grpc_service,
             service::IAuthService* business_service, util::IJwtUtil* jwt_util,
-            const std::shared_ptr<boost::asio::io_context>& ioc, grpc::ServerCompletionQueue *cq);
+            const std::vector<std::shared_ptr<boost::asio::io_context>>& iocs, const std::vector<grpc::ServerCompletionQueue*>& cqs);
         ~LoginByCodeCallDataManager() override;
 
         void SpecificRegisterCallDataToCQ(LoginByCodeCallData* call_data) const;
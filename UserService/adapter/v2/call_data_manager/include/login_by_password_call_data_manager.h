@@ -13,7 +13,7 @@ namespace user_service::adapter::v2 {
     public:
         LoginByPasswordCallDataManager(size_t initial_size, proto::v1::AuthService::AsyncService* grpc_service,
             service::IAuthService* business_service, util::IJwtUtil* jwt_util,
-            const std::shared_ptr<boost::asio::io_context>& ioc, grpc::ServerCompletionQueue *cq);
+            const std::vector<std::shared_ptr<boost::asio::io_context>>& iocs, const std::vector<grpc::ServerCompletionQueue*>& cqs);
         ~LoginByPasswordCallDataManager() override;
 
         void SpecificRegisterCallDataToCQ(LoginByPasswordCallData* call_data) const;
@@ -28,8 +28,9 @@ namespace user_service::adapter::v2 {
     class CallDataManager: public ICallDataManager {
     public:
         CallDataManager(const size_t initial_size, GrpcServiceType* grpc_service, BusinessServiceType* business_service,
-            util::IJwtUtil* jwt_util, const std::shared_ptr<boost::asio::io_context>& ioc, grpc::ServerCompletionQueue *cq):
-            ICallDataManager(initial_size, ioc, cq), grpc_service_(grpc_service),
+            util::IJwtUtil* jwt_util, const std::vector<std::shared_ptr<boost::asio::io_context>>& iocs,
+            const std::vector<grpc::ServerCompletionQueue*>& cqs):
+            ICallDataManager(initial_size, iocs, cqs), grpc_service_(grpc_service),
             business_service_(business_service), jwt_util_(jwt_util) {
             static_assert(std::is_base_of_v<ICallData, CallDataType>, "CallDataType must derive from ICallData");
 
@@ -42,10 +43,11 @@ namespace user_service::adapter::v2 {
         ~CallDataManager() override = default;
 
         void Start() {
-            // 初始化 call data
+            // 初始化 call data，轮流播种到各个 CQ 分片上
+            pool_.reserve(initial_size_);
             for (size_t i = 0; i < initial_size_; ++i) {
                 auto derived_this = static_cast<SpecificCallDataManagerType*>(this);
-                auto call_data = std::make_unique<CallDataType>(derived_this);
+                auto call_data = std::make_unique<CallDataType>(derived_this, i % cqs_.size());
                 RegisterCallDataToCQ(call_data.get());
                 pool_.push_back(std::move(call_data));
             }
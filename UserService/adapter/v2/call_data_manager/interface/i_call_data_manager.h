@@ -3,6 +3,7 @@
 
 #pragma once
 #include <memory>
+#include <vector>
 #include <UserService/v1/user_service.grpc.pb.h>
 #include <grpcpp/completion_queue.h>
 #include <boost/asio/io_context.hpp>
@@ -13,21 +14,45 @@ namespace user_service::adapter::v2 {
     // 提供 manager 统一接口
     class ICallDataManager {
     public:
-        ICallDataManager(const size_t initiate_size, const std::shared_ptr<boost::asio::io_context>& ioc, grpc::ServerCompletionQueue * cq):
-            initial_size_(initiate_size), ioc_(ioc), cq_(cq) {
-            if (!cq_) {
-                throw std::invalid_argument("CQ cannot be null.");
+        ICallDataManager(const size_t initiate_size, const std::vector<std::shared_ptr<boost::asio::io_context>>& iocs,
+            const std::vector<grpc::ServerCompletionQueue*>& cqs):
+            initial_size_(initiate_size), iocs_(iocs), cqs_(cqs) {
+            if (iocs_.empty()) {
+                throw std::invalid_argument("IO context list cannot be empty.");
+            }
+            if (cqs_.empty()) {
+                throw std::invalid_argument("CQ list cannot be empty.");
+            }
+            for (const auto* cq : cqs_) {
+                if (!cq) {
+                    throw std::invalid_argument("CQ cannot be null.");
+                }
             }
         }
         virtual ~ICallDataManager() = default;
         // 调用了这个函数就一定要用他的结果（编译期保证）
+        // per-core 模式下有多个 io_context，按当前 CQ 轮询线程的序号选择同核心的 io_context
         [[nodiscard]] boost::asio::io_context& GetIOContext() const {
-            return *ioc_;
+            return *iocs_[tls_poller_index_ % iocs_.size()];
+        }
+        // CQ 轮询线程启动时调用，记录本线程序号
+        static void BindPollerThread(const size_t poller_index) {
+            tls_poller_index_ = poller_index;
+        }
+        // CQ 分片数目（单 CQ 模式下为 1）
+        [[nodiscard]] size_t GetShardCount() const {
+            return cqs_.size();
+        }
+        // CallData 固定归属于某个分片，重新注册时必须回到同一个 CQ
+        [[nodiscard]] grpc::ServerCompletionQueue* GetCompletionQueue(const size_t shard_index) const {
+            return cqs_[shard_index];
         }
     protected:
         size_t initial_size_;
-        std::shared_ptr<boost::asio::io_context> ioc_;
-        grpc::ServerCompletionQueue *cq_;
+        std::vector<std::shared_ptr<boost::asio::io_context>> iocs_;
+        std::vector<grpc::ServerCompletionQueue*> cqs_;
+    private:
+        static inline thread_local size_t tls_poller_index_ = 0;
     };
 
 }
@@ -0,0 +1,19 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#include "adapter/v2/call_data_manager/include/get_jwks_call_data_manager.h"
+#include "adapter/v2/call_data/include/get_jwks_call_data.h"
+
+using namespace user_service::adapter::v2;
+
+GetJwksCallDataManager::GetJwksCallDataManager(const size_t initial_size, proto::v1::AuthService::AsyncService* grpc_service,
+            service::IAuthService* business_service, util::IJwtUtil* jwt_util,
+            const std::vector<std::shared_ptr<boost::asio::io_context>>& iocs, const std::vector<grpc::ServerCompletionQueue*>& cqs):
+        CallDataManager(initial_size, grpc_service, business_service, jwt_util, iocs, cqs) {}
+
+GetJwksCallDataManager::~GetJwksCallDataManager() = default;
+
+void GetJwksCallDataManager::SpecificRegisterCallDataToCQ(GetJwksCallData* call_data) const {
+    auto* cq = GetCompletionQueue(call_data->GetShardIndex());
+    grpc_service_->RequestGetJwks(call_data->GetContextAddress(), call_data->GetRequestAddress(), call_data->GetResponderAddress(), cq, cq, call_data);
+}
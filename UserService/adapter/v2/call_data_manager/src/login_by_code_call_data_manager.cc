@@ -8,11 +8,12 @@ using namespace user_service::adapter::v2;
 
 LoginByCodeCallDataManager::LoginByCodeCallDataManager(const size_t initial_size, proto::v1::AuthService::AsyncService* grpc_service,
             service::IAuthService* business_service, util::IJwtUtil* jwt_util
-            , const std::shared_ptr<boost::asio::io_context>& ioc, grpc::ServerCompletionQueue *cq)
-            : CallDataManager(initial_size, grpc_service, business_service, jwt_util, ioc, cq) {}
+            , const std::vector<std::shared_ptr<boost::asio::io_context>>& iocs, const std::vector<grpc::ServerCompletionQueue*>& cqs)
+            : CallDataManager(initial_size, grpc_service, business_service, jwt_util, iocs, cqs) {}
 
 LoginByCodeCallDataManager::~LoginByCodeCallDataManager() = default;
 
 void LoginByCodeCallDataManager::SpecificRegisterCallDataToCQ(LoginByCodeCallData* call_data) const {
-    grpc_service_->RequestLoginByCode(call_data->GetContextAddress(), call_data->GetRequestAddress(), call_data->GetResponderAddress(), cq_, cq_, call_data);
+    auto* cq = GetCompletionQueue(call_data->GetShardIndex());
+    grpc_service_->RequestLoginByCode(call_data->GetContextAddress(), call_data->GetRequestAddress(), call_data->GetResponderAddress(), cq, cq, call_data);
 }
\ No newline at end of file
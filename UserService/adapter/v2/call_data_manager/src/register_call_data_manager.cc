@@ -8,9 +8,9 @@ using namespace user_service::adapter::v2;
 
 RegisterCallDataManager::RegisterCallDataManager(const size_t initial_size, proto::v1::UserService::AsyncService* grpc_service,
             service::IBasicUserService* business_service, util::IJwtUtil* jwt_util,
-            const std::shared_ptr<boost::asio::io_context>& ioc, grpc::ServerCompletionQueue *cq):
-    CallDataManager(initial_size, grpc_service, business_service, jwt_util, ioc, cq) {
-    SPDLOG_INFO("DEBUG CHECK: RegisterCallDataManager ioc address: {}", fmt::ptr(ioc_.get()));
+            const std::vector<std::shared_ptr<boost::asio::io_context>>& iocs, const std::vector<grpc::ServerCompletionQueue*>& cqs):
+    CallDataManager(initial_size, grpc_service, business_service, jwt_util, iocs, cqs) {
+    SPDLOG_INFO("DEBUG CHECK: RegisterCallDataManager ioc address: {}, ioc count: {}", fmt::ptr(iocs_.front().get()), iocs_.size());
 }
 
 RegisterCallDataManager::~RegisterCallDataManager() = default;
@@ -18,6 +18,8 @@ RegisterCallDataManager::~RegisterCallDataManager() = default;
 void RegisterCallDataManager::SpecificRegisterCallDataToCQ(RegisterCallData* call_data) const {
 
     // grpc_service_->RequestRegister(&call_data->ctx_, &call_data->request_, &call_data->responder_, cq_, cq_, call_data);
-    grpc_service_->RequestRegister(call_data->GetContextAddress(), call_data->GetRequestAddress(), call_data->GetResponderAddress(), cq_, cq_, call_data);
+    // 注册回 CallData 所属分片的 CQ，保证同一个 CallData 始终由同一个 CQ 驱动
+    auto* cq = GetCompletionQueue(call_data->GetShardIndex());
+    grpc_service_->RequestRegister(call_data->GetContextAddress(), call_data->GetRequestAddress(), call_data->GetResponderAddress(), cq, cq, call_data);
 
 }
\ No newline at end of file
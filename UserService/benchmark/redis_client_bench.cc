@@ -0,0 +1,94 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+/*
+ * RedisClient 单条命令的微基准：对比进入连接串行区的两种方式 (post / dispatch)，以及是否开启自动流水线
+ * 需要一个可连接的 Redis，通过环境变量指定地址，未设置时跳过：
+ *   PHOTON_BENCH_REDIS_ADDR="127.0.0.1:6379" ./user_service_bench --benchmark_filter=Redis
+ * 参数为并发协程数，每个协程循环执行 GET，衡量的是客户端一侧的调度开销加上网络往返
+ * per-core 下协程与连接多数不在同一个 io_context，命令经子协程进入连接的 strand，完成后再回到协程自己的 io_context
+ */
+
+#include <benchmark/benchmark.h>
+#include <boost/asio.hpp>
+#include <cstdlib>
+#include <future>
+#include <optional>
+
+#include "infrastructure/asio_thread_pool/asio_thread_pool.h"
+#include "infrastructure/state_storage/redis_dao/redis_client.h"
+
+using namespace user_service::infrastructure;
+
+namespace {
+    constexpr int kPoolSize = 4;
+    constexpr int kOpsPerWorker = 200;
+    constexpr int kIoThreads = 4;
+    constexpr auto kBenchKey = "bench:redis_client:key";
+
+    std::optional<RedisConfig> GetRedisConfig() {
+        const char* addr = std::getenv("PHOTON_BENCH_REDIS_ADDR");
+        if (addr == nullptr) {
+            return std::nullopt;
+        }
+        const std::string_view addr_view(addr);
+        const auto colon = addr_view.rfind(':');
+        RedisConfig config;
+        config.host = std::string(addr_view.substr(0, colon));
+        config.port = colon == std::string_view::npos ? "6379" : std::string(addr_view.substr(colon + 1));
+        config.pool_size = kPoolSize;
+        config.near_cache = {false, 0, std::chrono::milliseconds(0), 1};
+        return config;
+    }
+
+    template<ExecutorModel Model, RedisExecMode Mode, bool AutoPipeline>
+    void BM_RedisGet(benchmark::State& state) {
+        auto config = GetRedisConfig();
+        if (!config) {
+            state.SkipWithError("PHOTON_BENCH_REDIS_ADDR not set");
+            return;
+        }
+        config->exec_mode = Mode;
+        config->auto_pipeline = AutoPipeline;
+
+        const auto ioc = std::make_shared<boost::asio::io_context>();
+        const auto thread_pool = std::make_shared<AsioThreadPool>(ioc, ThreadPoolConfig{Model, kIoThreads});
+        thread_pool->Run();
+        const auto client = std::make_shared<RedisClient>(thread_pool, *config);
+        boost::asio::co_spawn(*ioc, [client]() -> boost::asio::awaitable<void> {
+            co_await client->Init();
+            co_await client->Set(kBenchKey, std::string(256, 'x'));
+        }, boost::asio::use_future).get();
+
+        const auto workers = static_cast<int>(state.range(0));
+        for (auto _ : state) {
+            std::vector<std::future<void>> futures;
+            futures.reserve(workers);
+            for (int w = 0; w < workers; ++w) {
+                // 协程分散到各个 io_context (per-core 模式下才有多个)
+                const auto& worker_ioc = thread_pool->GetIOContext(w);
+                futures.push_back(boost::asio::co_spawn(*worker_ioc, [client]() -> boost::asio::awaitable<void> {
+                    for (int i = 0; i < kOpsPerWorker; ++i) {
+                        auto value = co_await client->Get(kBenchKey);
+                        benchmark::DoNotOptimize(value);
+                    }
+                }, boost::asio::use_future));
+            }
+            for (auto& f : futures) f.get();
+        }
+        state.SetItemsProcessed(state.iterations() * workers * kOpsPerWorker);
+        // 连接上的 async_run 会一直挂着，先停线程池再析构客户端
+        thread_pool->Stop();
+    }
+
+    void ConcurrencyArgs(benchmark::internal::Benchmark* b) {
+        // 1: 纯往返延迟；64: 连接上同时有多条命令，strand 更可能处于忙碌状态
+        b->Arg(1)->Arg(64)->UseRealTime()->Unit(benchmark::kMillisecond);
+    }
+}
+
+BENCHMARK(BM_RedisGet<ExecutorModel::Shared, RedisExecMode::Post, false>)->Name("Redis/Get/Shared/Post")->Apply(ConcurrencyArgs);
+BENCHMARK(BM_RedisGet<ExecutorModel::Shared, RedisExecMode::Dispatch, false>)->Name("Redis/Get/Shared/Dispatch")->Apply(ConcurrencyArgs);
+BENCHMARK(BM_RedisGet<ExecutorModel::PerCore, RedisExecMode::Post, false>)->Name("Redis/Get/PerCore/Post")->Apply(ConcurrencyArgs);
+BENCHMARK(BM_RedisGet<ExecutorModel::PerCore, RedisExecMode::Dispatch, false>)->Name("Redis/Get/PerCore/Dispatch")->Apply(ConcurrencyArgs);
+BENCHMARK(BM_RedisGet<ExecutorModel::PerCore, RedisExecMode::Dispatch, true>)->Name("Redis/Get/PerCore/Dispatch/AutoPipeline")->Apply(ConcurrencyArgs);
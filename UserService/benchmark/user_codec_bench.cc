@@ -0,0 +1,79 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+/*
+ * User 缓存编码的微基准：nlohmann::json 与二进制编码的编解码耗时和体积
+ *   ./user_service_bench --benchmark_filter=UserCodec
+ * 计数器 bytes 为单条编码后的字节数 (即 Redis 中一个 value 的大小)
+ */
+
+#include <benchmark/benchmark.h>
+#include "domain/user.h"
+
+using namespace user_service::domain;
+
+namespace {
+    User MakeUser(const bool full_profile) {
+        // 字段长度与线上数据一致：uuid、E.164 手机号、64 位十六进制哈希、16 字节盐
+        auto user = User::Create("0b0c8d4e-5f1a-4c2b-9d3e-7a6b5c4d3e2f", "+8613812345678",
+                                 "5E884898DA28047151D0E56F8DC6292773603D0D6AABBDD62A11EF721D1542D8",
+                                 "a1b2c3d4e5f6a7b8");
+        if (full_profile) {
+            user.UpdateProfile("benchmark_user", "benchmark_user@nus.edu.sg",
+                               "https://oss.example.com/avatars/0b0c8d4e-5f1a-4c2b-9d3e-7a6b5c4d3e2f.png");
+        }
+        return user;
+    }
+
+    void BM_JsonEncode(benchmark::State& state) {
+        const auto user = MakeUser(state.range(0));
+        size_t bytes = 0;
+        for (auto _ : state) {
+            auto encoded = user.ToJson().dump();
+            bytes = encoded.size();
+            benchmark::DoNotOptimize(encoded);
+        }
+        state.counters["bytes"] = static_cast<double>(bytes);
+    }
+
+    void BM_JsonDecode(benchmark::State& state) {
+        const auto encoded = MakeUser(state.range(0)).ToJson().dump();
+        for (auto _ : state) {
+            // 与 UserRepository 的缓存命中路径一致：不抛异常的 parse + FromJson
+            const auto j = nlohmann::json::parse(encoded, nullptr, false);
+            auto user = User::FromJson(j);
+            benchmark::DoNotOptimize(user);
+        }
+        state.counters["bytes"] = static_cast<double>(encoded.size());
+    }
+
+    void BM_BinaryEncode(benchmark::State& state) {
+        const auto user = MakeUser(state.range(0));
+        size_t bytes = 0;
+        for (auto _ : state) {
+            auto encoded = user.ToBinary();
+            bytes = encoded.size();
+            benchmark::DoNotOptimize(encoded);
+        }
+        state.counters["bytes"] = static_cast<double>(bytes);
+    }
+
+    void BM_BinaryDecode(benchmark::State& state) {
+        const auto encoded = MakeUser(state.range(0)).ToBinary();
+        for (auto _ : state) {
+            auto user = User::FromBinary(encoded);
+            benchmark::DoNotOptimize(user);
+        }
+        state.counters["bytes"] = static_cast<double>(encoded.size());
+    }
+
+    void ProfileArgs(benchmark::internal::Benchmark* b) {
+        // 0: 仅必填字段 (刚注册的用户)，1: 资料完整
+        b->ArgName("full_profile")->Arg(0)->Arg(1);
+    }
+}
+
+BENCHMARK(BM_JsonEncode)->Name("UserCodec/Json/Encode")->Apply(ProfileArgs);
+BENCHMARK(BM_JsonDecode)->Name("UserCodec/Json/Decode")->Apply(ProfileArgs);
+BENCHMARK(BM_BinaryEncode)->Name("UserCodec/Binary/Encode")->Apply(ProfileArgs);
+BENCHMARK(BM_BinaryDecode)->Name("UserCodec/Binary/Decode")->Apply(ProfileArgs);
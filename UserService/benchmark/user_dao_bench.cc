@@ -0,0 +1,115 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+/*
+ * UserDao::MapRowToUser 的微基准：在内存中构造与 SELECT 列一致的二进制结果集，不需要数据库
+ *   ./user_service_bench --benchmark_filter=UserDao
+ * 参数为行数 (1 为单条查询，64 为批量加载的一批)
+ */
+
+#include <benchmark/benchmark.h>
+#include <libpq-fe.h>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "infrastructure/persistence/dao/user_dao.h"
+#include "infrastructure/persistence/postgresql/include/pq_connection.h"
+
+using namespace user_service::infrastructure;
+
+namespace {
+    // pg_type.h 中的类型 oid
+    constexpr Oid kUuidOid = 2950;
+    constexpr Oid kVarcharOid = 1043;
+    constexpr Oid kInt2Oid = 21;
+    constexpr Oid kTimestamptzOid = 1184;
+
+    template<typename T>
+    std::string ToBigEndian(T value) {
+        if constexpr (std::endian::native == std::endian::little) {
+            value = std::byteswap(value);
+        }
+        std::string out(sizeof(T), '\0');
+        std::memcpy(out.data(), &value, sizeof(T));
+        return out;
+    }
+
+    void SetValue(PGresult* res, const int row, const int col, const std::string& value) {
+        if (!PQsetvalue(res, row, col, const_cast<char*>(value.data()), static_cast<int>(value.size()))) {
+            throw std::runtime_error("PQsetvalue failed");
+        }
+    }
+
+    void SetNull(PGresult* res, const int row, const int col) {
+        if (!PQsetvalue(res, row, col, nullptr, -1)) {
+            throw std::runtime_error("PQsetvalue failed");
+        }
+    }
+
+    // 列顺序：id, phone_number, username, email, password_hash, salt, avatar_url, status, created_at
+    PGResultPtr MakeUserResult(const int rows, const bool full_profile) {
+        PGResultPtr res(PQmakeEmptyPGresult(nullptr, PGRES_TUPLES_OK), &PQclear);
+        std::array<PGresAttDesc, 9> attrs{};
+        const std::array<std::pair<const char*, Oid>, 9> columns{{
+            {"id", kUuidOid}, {"phone_number", kVarcharOid}, {"username", kVarcharOid}, {"email", kVarcharOid},
+            {"password_hash", kVarcharOid}, {"salt", kVarcharOid}, {"avatar_url", kVarcharOid},
+            {"status", kInt2Oid}, {"created_at", kTimestamptzOid}
+        }};
+        for (size_t i = 0; i < attrs.size(); ++i) {
+            attrs[i].name = const_cast<char*>(columns[i].first);
+            attrs[i].typid = columns[i].second;
+            attrs[i].format = 1;
+            attrs[i].typlen = -1;
+            attrs[i].atttypmod = -1;
+        }
+        if (!PQsetResultAttrs(res.get(), static_cast<int>(attrs.size()), attrs.data())) {
+            throw std::runtime_error("PQsetResultAttrs failed");
+        }
+
+        for (int row = 0; row < rows; ++row) {
+            std::string uuid(16, '\0');
+            for (int i = 0; i < 16; ++i) {
+                uuid[i] = static_cast<char>((row * 31 + i * 7) & 0xFF);
+            }
+            SetValue(res.get(), row, 0, uuid);
+            SetValue(res.get(), row, 1, "+86138" + std::to_string(10000000 + row));
+            if (full_profile) {
+                SetValue(res.get(), row, 2, "benchmark_user_" + std::to_string(row));
+                SetValue(res.get(), row, 3, "benchmark_user_" + std::to_string(row) + "@nus.edu.sg");
+            } else {
+                SetNull(res.get(), row, 2);
+                SetNull(res.get(), row, 3);
+            }
+            SetValue(res.get(), row, 4, "5E884898DA28047151D0E56F8DC6292773603D0D6AABBDD62A11EF721D1542D8");
+            SetValue(res.get(), row, 5, "A1B2C3D4E5F6A7B8A1B2C3D4E5F6A7B8");
+            if (full_profile) {
+                SetValue(res.get(), row, 6, "https://oss.example.com/avatars/" + std::to_string(row) + ".png");
+            } else {
+                SetNull(res.get(), row, 6);
+            }
+            SetValue(res.get(), row, 7, ToBigEndian<int16_t>(0));
+            // 2025-01-01 00:00:00 UTC，自 2000-01-01 起的微秒数
+            SetValue(res.get(), row, 8, ToBigEndian<int64_t>(788918400LL * 1000000));
+        }
+        return res;
+    }
+
+    void BM_MapRowToUser(benchmark::State& state) {
+        const int rows = static_cast<int>(state.range(0));
+        const auto res = MakeUserResult(rows, state.range(1) != 0);
+        for (auto _ : state) {
+            for (int row = 0; row < rows; ++row) {
+                auto user = UserDao::MapRowToUser(res.get(), row);
+                benchmark::DoNotOptimize(user);
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * rows);
+    }
+}
+
+// 参数：行数, 是否带完整资料 (可空列非空)
+BENCHMARK(BM_MapRowToUser)->Name("UserDao/MapRowToUser")->ArgsProduct({{1, 64}, {0, 1}});
@@ -0,0 +1,233 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+/*
+ * 登录/鉴权热路径上工具类的微基准：JWT 签发与校验、密码哈希、UUIDv7 生成
+ *   ./user_service_bench --benchmark_filter='Jwt|Hmac|Password|IdGenerator'
+ * 多线程版本 (Threads) 用于观察共享状态 (随机数池、全局锁) 带来的争用
+ * Jwt/JwtCpp/* 是同样格式的令牌交给 jwt-cpp 处理的结果，作为专用 HS256 实现的对照
+ * Jwt/EdDSA/*、Jwt/ES256/* 使用启动时临时生成的密钥
+ */
+
+#undef JWT_DISABLE_PICOJSON
+#include <benchmark/benchmark.h>
+#include <jwt-cpp/jwt.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/pem.h>
+#include "utils/include/hmac_sha256_signer.h"
+#include "utils/include/id_generator.h"
+#include "utils/include/jwt_util.h"
+#include "utils/include/security_util.h"
+
+using namespace user_service::util;
+
+namespace {
+    // 与 config.yaml 中的 jwt 配置同量级
+    const JwtConfig kJwtConfig{"photon-commerce-secret-key-2025", "photon-commerce", 86400,
+                               {false, 0, std::chrono::milliseconds(0), 1}};
+    const JwtConfig kCachedJwtConfig{"photon-commerce-secret-key-2025", "photon-commerce", 86400,
+                                     {true, 100000, std::chrono::milliseconds(300000), 64}};
+    constexpr auto kUserId = "0b0c8d4e-5f1a-4c2b-9d3e-7a6b5c4d3e2f";
+    constexpr auto kPassword = "correct horse battery staple";
+
+    void BM_JwtGenerate(benchmark::State& state) {
+        JwtUtil jwt(kJwtConfig);
+        const std::string user_id = kUserId;
+        for (auto _ : state) {
+            auto token = jwt.GenerateToken(user_id);
+            benchmark::DoNotOptimize(token);
+        }
+    }
+
+    void BM_JwtVerify(benchmark::State& state) {
+        JwtUtil jwt(kJwtConfig);
+        const std::string token = jwt.GenerateToken(kUserId);
+        for (auto _ : state) {
+            auto user_id = jwt.VerifyToken(token);
+            benchmark::DoNotOptimize(user_id);
+        }
+    }
+
+    // 校验结果缓存命中：只剩哈希、分片锁和一次 token 比对
+    void BM_JwtVerifyCached(benchmark::State& state) {
+        static JwtUtil jwt(kCachedJwtConfig);
+        const std::string token = jwt.GenerateToken(kUserId);
+        benchmark::DoNotOptimize(jwt.VerifyToken(token));
+        for (auto _ : state) {
+            auto user_id = jwt.VerifyToken(token);
+            benchmark::DoNotOptimize(user_id);
+        }
+    }
+
+    /*
+     * 篡改签名：header 照常解析，在 HmacSha256Signer::Verify 的比对处失败，不解析 payload
+     * 改的是签名段中间的字符：末尾字符含 base64url 的填充位，改动后可能变成非规范编码，在解码阶段就被拒绝，测不到 HMAC
+     */
+    void BM_JwtVerifyInvalid(benchmark::State& state) {
+        JwtUtil jwt(kJwtConfig);
+        std::string token = jwt.GenerateToken(kUserId);
+        const size_t signature_begin = token.rfind('.') + 1;
+        char& c = token[signature_begin + (token.size() - signature_begin) / 2];
+        c = c == 'A' ? 'B' : 'A';
+        for (auto _ : state) {
+            auto user_id = jwt.VerifyToken(token);
+            benchmark::DoNotOptimize(user_id);
+        }
+    }
+
+    // 生成一把临时私钥并以 PEM 输出
+    std::string GeneratePrivateKeyPem(const std::string_view alg) {
+        EVP_PKEY* pkey = alg == "EdDSA" ? EVP_PKEY_Q_keygen(nullptr, nullptr, "ED25519")
+                                        : EVP_PKEY_Q_keygen(nullptr, nullptr, "EC", "P-256");
+        BIO* bio = BIO_new(BIO_s_mem());
+        PEM_write_bio_PrivateKey(bio, pkey, nullptr, nullptr, 0, nullptr, nullptr);
+        char* data = nullptr;
+        const long len = BIO_get_mem_data(bio, &data);
+        std::string pem(data, static_cast<size_t>(len));
+        BIO_free(bio);
+        EVP_PKEY_free(pkey);
+        return pem;
+    }
+
+    template<const char* Alg>
+    const JwtConfig& AsymmetricJwtConfig() {
+        static const JwtConfig config = [] {
+            JwtConfig c = kJwtConfig;
+            c.keys = {{"bench", "", Alg, GeneratePrivateKeyPem(Alg)}};
+            c.active_kid = "bench";
+            return c;
+        }();
+        return config;
+    }
+    constexpr char kEdDSA[] = "EdDSA";
+    constexpr char kES256[] = "ES256";
+
+    template<const char* Alg>
+    void BM_JwtGenerateAsymmetric(benchmark::State& state) {
+        JwtUtil jwt(AsymmetricJwtConfig<Alg>());
+        const std::string user_id = kUserId;
+        for (auto _ : state) {
+            auto token = jwt.GenerateToken(user_id);
+            benchmark::DoNotOptimize(token);
+        }
+    }
+
+    // 未开校验缓存：每次都做一次完整的公钥验签 (拷贝预初始化的上下文 + 验签)
+    template<const char* Alg>
+    void BM_JwtVerifyAsymmetric(benchmark::State& state) {
+        JwtUtil jwt(AsymmetricJwtConfig<Alg>());
+        const std::string token = jwt.GenerateToken(kUserId);
+        for (auto _ : state) {
+            auto user_id = jwt.VerifyToken(token);
+            benchmark::DoNotOptimize(user_id);
+        }
+    }
+
+    void BM_JwtCppGenerate(benchmark::State& state) {
+        for (auto _ : state) {
+            const auto now = std::chrono::system_clock::now();
+            auto token = jwt::create()
+                .set_issuer(kJwtConfig.issuer)
+                .set_type("JWS")
+                .set_payload_claim("user_id", picojson::value(kUserId))
+                .set_issued_at(now)
+                .set_expires_at(now + std::chrono::seconds(kJwtConfig.expiration_seconds))
+                .sign(jwt::algorithm::hs256{kJwtConfig.secret_key});
+            benchmark::DoNotOptimize(token);
+        }
+    }
+
+    void BM_JwtCppVerify(benchmark::State& state) {
+        const std::string token = JwtUtil(kJwtConfig).GenerateToken(kUserId);
+        const auto verifier = jwt::verify()
+            .allow_algorithm(jwt::algorithm::hs256{kJwtConfig.secret_key})
+            .with_issuer(kJwtConfig.issuer);
+        for (auto _ : state) {
+            const auto decoded = jwt::decode(token);
+            verifier.verify(decoded);
+            auto user_id = decoded.get_payload_claim("user_id").as_string();
+            benchmark::DoNotOptimize(user_id);
+        }
+    }
+
+    // 令牌签名原文的量级 (header.payload 约 150 字节)
+    const std::string kSigningInput(150, 'x');
+
+    // 预先吸收密钥：每条消息只拷贝两份中间状态
+    void BM_HmacPrekeyed(benchmark::State& state) {
+        static const HmacSha256Signer signer(kJwtConfig.secret_key);
+        for (auto _ : state) {
+            auto mac = signer.Sign({kSigningInput});
+            benchmark::DoNotOptimize(mac);
+        }
+    }
+
+    // 对照：OpenSSL 一次性接口，每次重新处理密钥
+    void BM_HmacOneShot(benchmark::State& state) {
+        unsigned char mac[EVP_MAX_MD_SIZE];
+        unsigned int len = 0;
+        for (auto _ : state) {
+            HMAC(EVP_sha256(), kJwtConfig.secret_key.data(), static_cast<int>(kJwtConfig.secret_key.size()),
+                 reinterpret_cast<const unsigned char*>(kSigningInput.data()), kSigningInput.size(), mac, &len);
+            benchmark::DoNotOptimize(mac);
+        }
+    }
+
+    void BM_HashPassword(benchmark::State& state) {
+        SecurityUtil security;
+        const std::string password = kPassword;
+        const std::string salt = security.GenerateSalt();
+        for (auto _ : state) {
+            auto hash = security.HashPassword(password, salt);
+            benchmark::DoNotOptimize(hash);
+        }
+    }
+
+    void BM_VerifyPassword(benchmark::State& state) {
+        SecurityUtil security;
+        const std::string password = kPassword;
+        const std::string salt = security.GenerateSalt();
+        const std::string hash = security.HashPassword(password, salt);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(security.VerifyPassword(password, salt, hash));
+        }
+    }
+
+    void BM_GenerateSalt(benchmark::State& state) {
+        SecurityUtil security;
+        for (auto _ : state) {
+            auto salt = security.GenerateSalt();
+            benchmark::DoNotOptimize(salt);
+        }
+    }
+
+    void BM_GenerateUUID(benchmark::State& state) {
+        IdGenerator generator;
+        for (auto _ : state) {
+            auto id = generator.GenerateUUID();
+            benchmark::DoNotOptimize(id);
+        }
+    }
+
+    void ThreadArgs(benchmark::internal::Benchmark* b) {
+        b->Threads(1)->Threads(4)->UseRealTime();
+    }
+}
+
+BENCHMARK(BM_JwtGenerate)->Name("Jwt/Generate")->Apply(ThreadArgs);
+BENCHMARK(BM_JwtVerify)->Name("Jwt/Verify")->Apply(ThreadArgs);
+BENCHMARK(BM_JwtVerifyCached)->Name("Jwt/VerifyCached")->Apply(ThreadArgs);
+BENCHMARK(BM_JwtVerifyInvalid)->Name("Jwt/VerifyInvalid");
+BENCHMARK(BM_JwtGenerateAsymmetric<kEdDSA>)->Name("Jwt/EdDSA/Generate")->Apply(ThreadArgs);
+BENCHMARK(BM_JwtVerifyAsymmetric<kEdDSA>)->Name("Jwt/EdDSA/Verify")->Apply(ThreadArgs);
+BENCHMARK(BM_JwtGenerateAsymmetric<kES256>)->Name("Jwt/ES256/Generate")->Apply(ThreadArgs);
+BENCHMARK(BM_JwtVerifyAsymmetric<kES256>)->Name("Jwt/ES256/Verify")->Apply(ThreadArgs);
+BENCHMARK(BM_JwtCppGenerate)->Name("Jwt/JwtCpp/Generate")->Apply(ThreadArgs);
+BENCHMARK(BM_JwtCppVerify)->Name("Jwt/JwtCpp/Verify")->Apply(ThreadArgs);
+BENCHMARK(BM_HmacPrekeyed)->Name("Hmac/Prekeyed")->Apply(ThreadArgs);
+BENCHMARK(BM_HmacOneShot)->Name("Hmac/OneShot")->Apply(ThreadArgs);
+BENCHMARK(BM_HashPassword)->Name("Password/Hash")->Apply(ThreadArgs);
+BENCHMARK(BM_VerifyPassword)->Name("Password/Verify")->Apply(ThreadArgs);
+BENCHMARK(BM_GenerateSalt)->Name("Password/GenerateSalt")->Apply(ThreadArgs);
+BENCHMARK(BM_GenerateUUID)->Name("IdGenerator/UUIDv7")->Apply(ThreadArgs);
@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 
 #include "config/app_config.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
 
 using namespace user_service::config;
 using namespace user_service::infrastructure;
@@ -15,6 +18,7 @@ AppConfig::AppConfig(const std::string& config_path) {
         ParseRpcLimitsConfig(root_node);
         ParseRedisConfig(root_node);
         ParseDbConfig(root_node);
+        ParseLocalCacheConfig(root_node);
         ParseJwtConfig(root_node);
     } catch (const YAML::Exception& e) {
         SPDLOG_CRITICAL("Error parsing YAML file '{}': {}", config_path, e.what());
@@ -45,6 +49,11 @@ void AppConfig::ParseServerConfig(const YAML::Node& root_node) {
     const std::string registry_ip = node["registry_ip"].as<std::string>();
     const int listen_threads = node["listen_threads"].as<int>();
     const int worker_threads = node["worker_threads"].as<int>();
+    // 可选项，缺省保持单 CQ 模式
+    const std::string cq_mode = node["cq_mode"] ? node["cq_mode"].as<std::string>() : "single";
+    // 可选项，缺省保持所有线程共享一个 io_context
+    const std::string executor_model = node["executor_model"] ? node["executor_model"].as<std::string>() : "shared";
+    const int io_threads = node["io_threads"] ? node["io_threads"].as<int>() : 0;
 
     // 校验
     ValidateNotEmpty(name, "Server Name");
@@ -57,6 +66,15 @@ void AppConfig::ParseServerConfig(const YAML::Node& root_node) {
     if (worker_threads < 0) {
         throw std::runtime_error(fmt::format("Config Error: Invalid worker_threads {}", worker_threads));
     }
+    if (cq_mode != "single" && cq_mode != "sharded") {
+        throw std::runtime_error(fmt::format("Config Error: Invalid cq_mode '{}', expected 'single' or 'sharded'", cq_mode));
+    }
+    if (executor_model != "shared" && executor_model != "per_core") {
+        throw std::runtime_error(fmt::format("Config Error: Invalid executor_model '{}', expected 'shared' or 'per_core'", executor_model));
+    }
+    if (io_threads < 0) {
+        throw std::runtime_error(fmt::format("Config Error: Invalid io_threads {}", io_threads));
+    }
 
     const unsigned hw_conc = std::thread::hardware_concurrency();
     // 极端情况下获取不到(返回0)则兜底为2
@@ -67,13 +85,18 @@ void AppConfig::ParseServerConfig(const YAML::Node& root_node) {
     server_config_.port = port;
     server_config_.listen_threads = (listen_threads == 0) ? auto_cpu_cores : listen_threads;
     server_config_.worker_threads = (worker_threads == 0) ? auto_cpu_cores : worker_threads;
+    server_config_.cq_mode = (cq_mode == "sharded") ? server::CqMode::Sharded : server::CqMode::Single;
+
+    // 赋值 ThreadPoolConfig
+    thread_pool_config_.model = (executor_model == "per_core") ? ExecutorModel::PerCore : ExecutorModel::Shared;
+    thread_pool_config_.thread_count = (io_threads == 0) ? auto_cpu_cores : io_threads;
     server_config_.register_info.service_name = name;
     server_config_.register_info.ip = registry_ip;
     server_config_.register_info.port = port;
     server_config_.register_info.tags = {"v1", "stable"}; // 暂时使用默认标签
 
-    SPDLOG_INFO("Server config loaded. Name: {}, Bind: {}:{}, RegistryIP: {}",
-        name, bind_ip, port, registry_ip);
+    SPDLOG_INFO("Server config loaded. Name: {}, Bind: {}:{}, RegistryIP: {}, CqMode: {}, ExecutorModel: {}",
+        name, bind_ip, port, registry_ip, cq_mode, executor_model);
 }
 
 void AppConfig::ParseConsulConfig(const YAML::Node& root_node) {
@@ -128,9 +151,11 @@ void AppConfig::ParseRpcLimitsConfig(const YAML::Node& root_node) {
     const int login_pw = node["login_pw"].as<int>();
     const int login_code = node["login_code"].as<int>();
     const int get_info = node["get_user_info"].as<int>();
+    // 低频接口 (网关/其他服务启动或刷新公钥时才访问)，可省略
+    const int get_jwks = node["get_jwks"] ? node["get_jwks"].as<int>() : 16;
 
     // 校验 (calldata 数目大于0)
-    if (reg <= 0 || send_code <= 0 || login_pw <= 0 || login_code <= 0 || get_info <= 0) {
+    if (reg <= 0 || send_code <= 0 || login_pw <= 0 || login_code <= 0 || get_info <= 0 || get_jwks <= 0) {
         throw std::runtime_error("Config Error: All RPC limits must be positive integers");
     }
 
@@ -140,6 +165,7 @@ void AppConfig::ParseRpcLimitsConfig(const YAML::Node& root_node) {
     rpc_limits_config_.login_pw_num = login_pw;
     rpc_limits_config_.login_code_num = login_code;
     rpc_limits_config_.get_user_info_num = get_info;
+    rpc_limits_config_.get_jwks_num = get_jwks;
 
     SPDLOG_INFO("RPC Limits loaded. Register: {}, GetUserInfo: {}", reg, get_info);
 }
@@ -157,6 +183,11 @@ void AppConfig::ParseRedisConfig(const YAML::Node& root_node) {
     const std::string host = redis_node["host"].as<std::string>();
     const int port = redis_node["port"].as<int>();
     const int pool_size = redis_node["pool_size"].as<int>();
+    const bool auto_pipeline = redis_node["auto_pipeline"] ? redis_node["auto_pipeline"].as<bool>() : false;
+    const int pipeline_max_batch = redis_node["pipeline_max_batch"] ? redis_node["pipeline_max_batch"].as<int>() : 64;
+    const std::string exec_mode = redis_node["exec_mode"] ? redis_node["exec_mode"].as<std::string>() : "dispatch";
+    const std::string mode = redis_node["mode"] ? redis_node["mode"].as<std::string>() : "standalone";
+    const bool replica_reads = redis_node["replica_reads"] ? redis_node["replica_reads"].as<bool>() : false;
 
     // 校验
     ValidateNotEmpty(host, "Redis Host");
@@ -164,13 +195,53 @@ void AppConfig::ParseRedisConfig(const YAML::Node& root_node) {
     if (pool_size <= 0 || pool_size > 1000) {
         throw std::runtime_error(fmt::format("Config Error: Invalid Redis pool_size {}", pool_size));
     }
+    if (pipeline_max_batch <= 0 || pipeline_max_batch > 10000) {
+        throw std::runtime_error(fmt::format("Config Error: Invalid Redis pipeline_max_batch {}", pipeline_max_batch));
+    }
+    if (exec_mode != "dispatch" && exec_mode != "post") {
+        throw std::runtime_error(fmt::format("Config Error: Invalid Redis exec_mode '{}', expected 'dispatch' or 'post'", exec_mode));
+    }
+    if (mode != "standalone" && mode != "cluster") {
+        throw std::runtime_error(fmt::format("Config Error: Invalid Redis mode '{}', expected 'standalone' or 'cluster'", mode));
+    }
+    // 副本列表只在 standalone 模式下使用，cluster 模式的副本由 CLUSTER SLOTS 发现
+    std::vector<RedisEndpoint> replicas;
+    if (const auto& replicas_node = redis_node["replicas"]) {
+        if (!replicas_node.IsSequence()) {
+            throw std::runtime_error("Config Error: 'redis.replicas' must be a list");
+        }
+        for (const auto& replica_node : replicas_node) {
+            if (!replica_node["host"] || !replica_node["port"]) {
+                throw std::runtime_error("Config Error: Missing 'host' or 'port' in 'redis.replicas'");
+            }
+            const std::string replica_host = replica_node["host"].as<std::string>();
+            const int replica_port = replica_node["port"].as<int>();
+            ValidateNotEmpty(replica_host, "Redis Replica Host");
+            ValidatePort(replica_port, "Redis Replica Port");
+            replicas.push_back(RedisEndpoint{replica_host, std::to_string(replica_port)});
+        }
+    }
 
     // 赋值
     redis_config_.host = host;
     redis_config_.port = std::to_string(port);
     redis_config_.pool_size = pool_size;
+    redis_config_.mode = mode == "cluster" ? RedisMode::Cluster : RedisMode::Standalone;
+    redis_config_.replica_reads = replica_reads;
+    redis_config_.replicas = std::move(replicas);
+    redis_config_.auto_pipeline = auto_pipeline;
+    redis_config_.pipeline_max_batch = static_cast<size_t>(pipeline_max_batch);
+    redis_config_.exec_mode = exec_mode == "post" ? RedisExecMode::Post : RedisExecMode::Dispatch;
+    // 近端缓存可选，缺省关闭
+    if (redis_node["near_cache"]) {
+        redis_config_.near_cache = ParseCacheNode(redis_node["near_cache"], "redis.near_cache");
+    } else {
+        redis_config_.near_cache = {false, 0, std::chrono::milliseconds(0), 1};
+    }
 
-    SPDLOG_INFO("Redis config loaded: {}:{}, PoolSize: {}", redis_config_.host, redis_config_.port, pool_size);
+    SPDLOG_INFO("Redis config loaded: {}:{} ({}), PoolSize: {}, ExecMode: {}, AutoPipeline: {}, ReplicaReads: {}, NearCache: {}",
+        redis_config_.host, redis_config_.port, mode, pool_size, exec_mode, auto_pipeline, replica_reads,
+        redis_config_.near_cache.enabled);
 }
 
 void AppConfig::ParseDbConfig(const YAML::Node& root_node) {
@@ -192,6 +263,12 @@ void AppConfig::ParseDbConfig(const YAML::Node& root_node) {
     const std::string pwd = db_node["password"].as<std::string>();
     const std::string dbname = db_node["dbname"].as<std::string>();
     const int pool_size = db_node["pool_size"].as<int>();
+    const std::string pool_impl = db_node["pool_impl"] ? db_node["pool_impl"].as<std::string>() : "strand";
+    const int max_pool_size = db_node["max_pool_size"] ? db_node["max_pool_size"].as<int>() : pool_size;
+    const int idle_timeout = db_node["idle_timeout_seconds"] ? db_node["idle_timeout_seconds"].as<int>() : 60;
+    const int health_check_interval = db_node["health_check_interval_seconds"] ? db_node["health_check_interval_seconds"].as<int>() : 30;
+    const int batch_window_us = db_node["batch_window_us"] ? db_node["batch_window_us"].as<int>() : 0;
+    const int batch_max_size = db_node["batch_max_size"] ? db_node["batch_max_size"].as<int>() : 64;
 
     // 校验
     ValidateNotEmpty(host, "DB Host");
@@ -201,36 +278,160 @@ void AppConfig::ParseDbConfig(const YAML::Node& root_node) {
     if (pool_size <= 0 || pool_size > 1000) {
         throw std::runtime_error(fmt::format("Config Error: Invalid DB pool_size {}", pool_size));
     }
+    if (max_pool_size < pool_size || max_pool_size > 1000) {
+        throw std::runtime_error(fmt::format("Config Error: Invalid DB max_pool_size {}, expected [{}, 1000]", max_pool_size, pool_size));
+    }
+    if (idle_timeout <= 0 || health_check_interval < 0) {
+        throw std::runtime_error(fmt::format("Config Error: Invalid DB idle_timeout_seconds {} or health_check_interval_seconds {}",
+            idle_timeout, health_check_interval));
+    }
+    if (batch_window_us < 0 || batch_window_us > 100000 || batch_max_size <= 0 || batch_max_size > 1000) {
+        throw std::runtime_error(fmt::format("Config Error: Invalid DB batch_window_us {} or batch_max_size {}",
+            batch_window_us, batch_max_size));
+    }
+    if (pool_impl != "strand" && pool_impl != "lock_free" && pool_impl != "pipeline") {
+        throw std::runtime_error(fmt::format("Config Error: Invalid DB pool_impl '{}', expected 'strand', 'lock_free' or 'pipeline'", pool_impl));
+    }
 
     // 赋值
     db_pool_config_.conn_str = fmt::format("postgresql://{}:{}@{}:{}/{}",
                                           user, pwd, host, port, dbname);
     db_pool_config_.pool_size = pool_size;
-    SPDLOG_INFO("Database config loaded. Host: {}, PoolSize: {}", host, db_pool_config_.pool_size);
+    if (pool_impl == "lock_free") {
+        db_pool_config_.impl = DbPoolImpl::LockFree;
+    } else if (pool_impl == "pipeline") {
+        db_pool_config_.impl = DbPoolImpl::Pipeline;
+    } else {
+        db_pool_config_.impl = DbPoolImpl::Strand;
+    }
+    db_pool_config_.max_pool_size = max_pool_size;
+    db_pool_config_.idle_timeout = std::chrono::seconds(idle_timeout);
+    db_pool_config_.health_check_interval = std::chrono::seconds(health_check_interval);
+    user_batch_config_.window = std::chrono::microseconds(batch_window_us);
+    user_batch_config_.max_batch_size = static_cast<size_t>(batch_max_size);
+    SPDLOG_INFO("Database config loaded. Host: {}, PoolSize: {}-{}, PoolImpl: {}", host, pool_size, max_pool_size, pool_impl);
+}
+
+void AppConfig::ParseLocalCacheConfig(const YAML::Node& root_node) {
+    // 整个节点可选，缺省关闭
+    if (!root_node["local_cache"]) {
+        local_cache_config_ = {false, 0, std::chrono::milliseconds(0), 1};
+        SPDLOG_INFO("Local cache disabled (no 'local_cache' section).");
+        return;
+    }
+    local_cache_config_ = ParseCacheNode(root_node["local_cache"], "local_cache");
+    SPDLOG_INFO("Local cache config loaded. Enabled: {}, MaxEntries: {}, TTL: {}ms, Shards: {}", local_cache_config_.enabled,
+        local_cache_config_.max_entries, local_cache_config_.ttl.count(), local_cache_config_.shard_count);
 }
 
 void AppConfig::ParseJwtConfig(const YAML::Node& root_node) {
+    jwt_config_ = ParseJwtNode(root_node);
+    SPDLOG_INFO("JWT config loaded. Issuer: {}, Keys: {}, ActiveKid: '{}', VerifyCache: {}", jwt_config_.issuer,
+        jwt_config_.keys.size(), jwt_config_.active_kid, jwt_config_.verify_cache.enabled);
+}
+
+util::JwtConfig AppConfig::LoadJwtConfig(const std::string& config_path) {
+    try {
+        return ParseJwtNode(YAML::LoadFile(config_path));
+    } catch (const YAML::Exception& e) {
+        throw std::runtime_error(fmt::format("Error parsing YAML file '{}': {}", config_path, e.what()));
+    }
+}
+
+util::JwtConfig AppConfig::ParseJwtNode(const YAML::Node& root_node) {
     // 一级节点检查
     if (!root_node["jwt"]) throw std::runtime_error("Missing 'jwt' section");
     const auto& node = root_node["jwt"];
     // 二级节点检查
-    if (!node["secret_key"]) throw std::runtime_error("Config Error: Missing 'jwt.secret_key'");
     if (!node["issuer"]) throw std::runtime_error("Config Error: Missing 'jwt.issuer'");
     if (!node["expiration_seconds"]) throw std::runtime_error("Config Error: Missing 'jwt.expiration_seconds'");
 
     // 取值
-    const std::string secret = node["secret_key"].as<std::string>();
+    // 配置了 keys 之后 secret_key 可省略，此时不再接受不带 kid 的令牌
+    const std::string secret = node["secret_key"] ? node["secret_key"].as<std::string>() : "";
     const std::string issuer = node["issuer"].as<std::string>();
     const int expire = node["expiration_seconds"].as<int>();
+    const std::string active_kid = node["active_kid"] ? node["active_kid"].as<std::string>() : "";
+    const int reload_seconds = node["keys_reload_seconds"] ? node["keys_reload_seconds"].as<int>() : 0;
 
     // 校验
-    ValidateNotEmpty(secret, "JWT Secret Key");
     ValidateNotEmpty(issuer, "JWT Issuer");
     if (expire <= 0) throw std::runtime_error("Config Error: JWT expiration_seconds must be positive");
+    if (reload_seconds < 0) {
+        throw std::runtime_error(fmt::format("Config Error: Invalid jwt.keys_reload_seconds {}", reload_seconds));
+    }
+    std::vector<util::JwtKey> keys;
+    std::vector<std::string> key_files;
+    if (const auto& keys_node = node["keys"]) {
+        if (!keys_node.IsSequence()) {
+            throw std::runtime_error("Config Error: 'jwt.keys' must be a list");
+        }
+        for (const auto& key_node : keys_node) {
+            if (!key_node["kid"]) throw std::runtime_error("Config Error: Missing 'kid' in 'jwt.keys'");
+            util::JwtKey key;
+            key.kid = key_node["kid"].as<std::string>();
+            key.alg = key_node["alg"] ? key_node["alg"].as<std::string>() : "HS256";
+            ValidateNotEmpty(key.kid, "JWT Key kid");
+            if (key.alg == "HS256") {
+                if (!key_node["secret"]) {
+                    throw std::runtime_error(fmt::format("Config Error: Missing 'secret' for HS256 key '{}'", key.kid));
+                }
+                key.secret = key_node["secret"].as<std::string>();
+                ValidateNotEmpty(key.secret, "JWT Key secret");
+            } else if (key.alg == "EdDSA" || key.alg == "ES256") {
+                // 私钥用于签发；只有公钥时该 kid 只能校验
+                const auto& file_node = key_node["private_key_file"] ? key_node["private_key_file"] : key_node["public_key_file"];
+                if (!file_node) {
+                    throw std::runtime_error(fmt::format(
+                        "Config Error: Missing 'private_key_file' or 'public_key_file' for {} key '{}'", key.alg, key.kid));
+                }
+                key_files.push_back(file_node.as<std::string>());
+                key.key_pem = ReadFile(key_files.back(), "JWT Key file");
+            } else {
+                throw std::runtime_error(fmt::format(
+                    "Config Error: Invalid alg '{}' for JWT key '{}', expected 'HS256', 'EdDSA' or 'ES256'", key.alg, key.kid));
+            }
+            keys.push_back(std::move(key));
+        }
+    }
+    if (active_kid.empty()) {
+        ValidateNotEmpty(secret, "JWT Secret Key");
+    } else if (std::ranges::none_of(keys, [&active_kid](const auto& key) { return key.kid == active_kid; })) {
+        throw std::runtime_error(fmt::format("Config Error: jwt.active_kid '{}' not found in 'jwt.keys'", active_kid));
+    }
 
     // 赋值
-    jwt_config_ = {secret, issuer, expire};
-    SPDLOG_INFO("JWT config loaded. Issuer: {}", issuer);
+    util::JwtConfig jwt_config{secret, issuer, expire, {false, 0, std::chrono::milliseconds(0), 1}};
+    // 校验结果缓存可选，缺省关闭
+    if (node["verify_cache"]) {
+        jwt_config.verify_cache = ParseCacheNode(node["verify_cache"], "jwt.verify_cache");
+    }
+    jwt_config.keys = std::move(keys);
+    jwt_config.active_kid = active_kid;
+    jwt_config.key_files = std::move(key_files);
+    jwt_config.keys_reload_seconds = reload_seconds;
+    return jwt_config;
+}
+
+LocalCacheConfig AppConfig::ParseCacheNode(const YAML::Node& node, const std::string& field_name) {
+    // 取值
+    const bool enabled = node["enabled"] ? node["enabled"].as<bool>() : true;
+    const int max_entries = node["max_entries"] ? node["max_entries"].as<int>() : 100000;
+    const int ttl_ms = node["ttl_ms"] ? node["ttl_ms"].as<int>() : 5000;
+    const int shards = node["shards"] ? node["shards"].as<int>() : 64;
+
+    // 校验
+    if (max_entries <= 0 || max_entries > 10000000) {
+        throw std::runtime_error(fmt::format("Config Error: Invalid {}.max_entries {}", field_name, max_entries));
+    }
+    if (ttl_ms <= 0) {
+        throw std::runtime_error(fmt::format("Config Error: Invalid {}.ttl_ms {}", field_name, ttl_ms));
+    }
+    if (shards <= 0 || shards > 4096) {
+        throw std::runtime_error(fmt::format("Config Error: Invalid {}.shards {}", field_name, shards));
+    }
+
+    return {enabled, static_cast<size_t>(max_entries), std::chrono::milliseconds(ttl_ms), static_cast<size_t>(shards)};
 }
 
 void AppConfig::ValidatePort(int port, const std::string& field_name) {
@@ -245,4 +446,14 @@ void AppConfig::ValidateNotEmpty(const std::string& value, const std::string& fi
     if (value.empty()) {
         throw std::runtime_error(fmt::format("Config Error: '{}' cannot be empty", field_name));
     }
-}
\ No newline at end of file
+}
+
+std::string AppConfig::ReadFile(const std::string& path, const std::string& field_name) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error(fmt::format("Config Error: Cannot open {} '{}'", field_name, path));
+    }
+    std::ostringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
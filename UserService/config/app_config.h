@@ -7,7 +7,10 @@
 #include "server/user_service_server.h"
 #include "service_registry/include/consul_registry.h"
 #include "infrastructure/state_storage/redis_dao/redis_client.h"
-#include "infrastructure/persistence/postgresql/include/async_connection_pool.h"
+#include "infrastructure/persistence/postgresql/interface/i_connection_pool.h"
+#include "infrastructure/persistence/dao/user_batch_loader.h"
+#include "infrastructure/asio_thread_pool/asio_thread_pool.h"
+#include "infrastructure/local_cache/sharded_lru_cache.h"
 #include "utils/include/jwt_util.h"
 
 namespace user_service::config {
@@ -21,11 +24,17 @@ namespace user_service::config {
 
         server::ServerConfig GetServerConfig() const { return server_config_; }
         server::RpcLimitsConfig GetRpcLimitsConfig() const { return rpc_limits_config_; }
+        infrastructure::ThreadPoolConfig GetThreadPoolConfig() const { return thread_pool_config_; }
         registry::ConsulConfig GetConsulConfig() const { return consul_config_; }
         infrastructure::RedisConfig GetRedisConfig() const { return redis_config_; };
         infrastructure::DbPoolConfig GetDBPoolConfig() const { return db_pool_config_; };
+        infrastructure::UserBatchConfig GetUserBatchConfig() const { return user_batch_config_; };
+        infrastructure::LocalCacheConfig GetLocalCacheConfig() const { return local_cache_config_; }
         util::JwtConfig GetJwtConfig() const { return jwt_config_; }
 
+        // 只重新读取 jwt 节点，用于运行期热加载密钥；出错时抛出 std::runtime_error
+        static util::JwtConfig LoadJwtConfig(const std::string& config_path);
+
     private:
         // YAML::Node，代表配置树的一个节点
         void ParseServerConfig(const YAML::Node& root_node);
@@ -33,17 +42,27 @@ namespace user_service::config {
         void ParseRpcLimitsConfig(const YAML::Node& root_node);
         void ParseRedisConfig(const YAML::Node& root_node);
         void ParseDbConfig(const YAML::Node& root_node);
+        void ParseLocalCacheConfig(const YAML::Node& root_node);
         void ParseJwtConfig(const YAML::Node& root_node);
+        static util::JwtConfig ParseJwtNode(const YAML::Node& root_node);
 
         /* 校验逻辑 */
         static void ValidatePort(int port, const std::string& field_name);
         static void ValidateNotEmpty(const std::string& value, const std::string& field_name);
+        // 读取配置引用的文件 (如 PEM 密钥) 的全部内容
+        static std::string ReadFile(const std::string& path, const std::string& field_name);
+
+        // 解析一个缓存节点 (local_cache / redis.near_cache)，字段均可选
+        static infrastructure::LocalCacheConfig ParseCacheNode(const YAML::Node& node, const std::string& field_name);
 
         server::ServerConfig server_config_;
         server::RpcLimitsConfig rpc_limits_config_;
+        infrastructure::ThreadPoolConfig thread_pool_config_;
         registry::ConsulConfig consul_config_;
         infrastructure::RedisConfig redis_config_;
         infrastructure::DbPoolConfig db_pool_config_;
+        infrastructure::UserBatchConfig user_batch_config_;
+        infrastructure::LocalCacheConfig local_cache_config_;
         util::JwtConfig jwt_config_;
     };
 }
\ No newline at end of file
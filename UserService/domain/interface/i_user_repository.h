@@ -5,6 +5,7 @@
 #include <boost/asio.hpp>
 #include <optional>
 #include <expected>
+#include <vector>
 #include "domain/user.h"
 #include "infrastructure/persistence/postgresql/include/db_error.h"
 
@@ -17,5 +18,7 @@ namespace user_service::domain
         virtual boost::asio::awaitable<std::expected<void, infrastructure::DbError>> CreateUser(const User& user) = 0;
         virtual boost::asio::awaitable<std::expected<std::optional<User>, infrastructure::DbError>> GetUserById(const std::string& id) = 0;
         virtual boost::asio::awaitable<std::expected<std::optional<User>, infrastructure::DbError>> GetUserByPhoneNumber(const std::string& phoneNumber) = 0;
+        // 批量获取，结果与 ids 一一对应，不存在的用户为 nullopt
+        virtual boost::asio::awaitable<std::expected<std::vector<std::optional<User>>, infrastructure::DbError>> GetUsersByIds(const std::vector<std::string>& ids) = 0;
     };
 }
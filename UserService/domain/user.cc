@@ -6,6 +6,100 @@
 using namespace user_service::domain;
 using json = nlohmann::json;
 
+namespace {
+    enum BinaryFlag : uint8_t {
+        kHasUsername = 1 << 0,
+        kHasEmail = 1 << 1,
+        kHasAvatar = 1 << 2,
+        kHasDeletedAt = 1 << 3
+    };
+
+    size_t VarintSize(uint64_t value) {
+        size_t n = 1;
+        while (value >= 0x80) {
+            value >>= 7;
+            ++n;
+        }
+        return n;
+    }
+
+    void PutVarint(std::string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    template<typename T>
+    void PutFixed(std::string& out, const T value) {
+        auto u = static_cast<std::make_unsigned_t<T>>(value);
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            out.push_back(static_cast<char>(u & 0xFF));
+            u >>= 8;
+        }
+    }
+
+    void PutString(std::string& out, const std::string& value) {
+        PutVarint(out, value.size());
+        out.append(value);
+    }
+
+    int64_t ToMicros(const User::TimePoint& tp) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(tp.time_since_epoch()).count();
+    }
+
+    // 只读游标，任何越界都置 ok = false，之后的读取全部失败
+    class BinaryReader {
+    public:
+        explicit BinaryReader(const std::string_view data) : data_(data) {}
+
+        [[nodiscard]] bool Ok() const { return ok_; }
+        [[nodiscard]] bool AtEnd() const { return pos_ == data_.size(); }
+
+        template<typename T>
+        T Fixed() {
+            if (!ok_ || data_.size() - pos_ < sizeof(T)) {
+                ok_ = false;
+                return T{};
+            }
+            std::make_unsigned_t<T> u = 0;
+            for (size_t i = 0; i < sizeof(T); ++i) {
+                u |= static_cast<std::make_unsigned_t<T>>(static_cast<uint8_t>(data_[pos_ + i])) << (8 * i);
+            }
+            pos_ += sizeof(T);
+            return static_cast<T>(u);
+        }
+
+        std::string String() {
+            uint64_t len = 0;
+            for (int shift = 0; ; shift += 7) {
+                if (!ok_ || pos_ >= data_.size() || shift > 63) {
+                    ok_ = false;
+                    return {};
+                }
+                const auto byte = static_cast<uint8_t>(data_[pos_++]);
+                len |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    break;
+                }
+            }
+            if (data_.size() - pos_ < len) {
+                ok_ = false;
+                return {};
+            }
+            std::string value(data_.substr(pos_, len));
+            pos_ += len;
+            return value;
+        }
+
+    private:
+        std::string_view data_;
+        size_t pos_ = 0;
+        bool ok_ = true;
+    };
+}
+
 void User::ChangePassword(const std::string& new_hash, const std::string& new_salt) {
     if (new_hash.empty() || new_salt.empty()) {
         throw std::invalid_argument("Hash and salt cannot be empty");
@@ -66,4 +160,63 @@ std::optional<User> User::FromJson(const nlohmann::json& j) {
         SPDLOG_ERROR("User JSON deserialization failed: {}", e.what());
         return std::nullopt;
     }
-}
\ No newline at end of file
+}
+
+std::string User::ToBinary() const {
+    uint8_t flags = 0;
+    if (username_.has_value()) flags |= kHasUsername;
+    if (email_.has_value()) flags |= kHasEmail;
+    if (avatar_url_.has_value()) flags |= kHasAvatar;
+    if (deleted_at_.has_value()) flags |= kHasDeletedAt;
+
+    // 先算出总长度，只分配一次
+    auto string_size = [](const std::string& value) { return VarintSize(value.size()) + value.size(); };
+    size_t size = 1 + 1 + sizeof(int16_t) + 1 + sizeof(int64_t);
+    if (deleted_at_.has_value()) size += sizeof(int64_t);
+    size += string_size(id_) + string_size(phone_number_) + string_size(password_hash_) + string_size(salt_);
+    if (username_.has_value()) size += string_size(*username_);
+    if (email_.has_value()) size += string_size(*email_);
+    if (avatar_url_.has_value()) size += string_size(*avatar_url_);
+
+    std::string out;
+    out.reserve(size);
+    out.push_back(static_cast<char>(kBinaryMagic));
+    out.push_back(static_cast<char>(kBinaryVersion));
+    PutFixed(out, static_cast<int16_t>(status_));
+    out.push_back(static_cast<char>(flags));
+    PutFixed(out, ToMicros(created_at_));
+    if (deleted_at_.has_value()) PutFixed(out, ToMicros(*deleted_at_));
+    PutString(out, id_);
+    PutString(out, phone_number_);
+    PutString(out, password_hash_);
+    PutString(out, salt_);
+    if (username_.has_value()) PutString(out, *username_);
+    if (email_.has_value()) PutString(out, *email_);
+    if (avatar_url_.has_value()) PutString(out, *avatar_url_);
+    return out;
+}
+
+std::optional<User> User::FromBinary(const std::string_view data) {
+    if (data.size() < 2 || static_cast<uint8_t>(data[0]) != kBinaryMagic || static_cast<uint8_t>(data[1]) != kBinaryVersion) {
+        return std::nullopt;
+    }
+    BinaryReader reader(data.substr(2));
+    User u;
+    u.status_ = static_cast<UserStatus>(reader.Fixed<int16_t>());
+    const auto flags = reader.Fixed<uint8_t>();
+    u.created_at_ = TimePoint(std::chrono::microseconds(reader.Fixed<int64_t>()));
+    if (flags & kHasDeletedAt) u.deleted_at_ = TimePoint(std::chrono::microseconds(reader.Fixed<int64_t>()));
+    u.id_ = reader.String();
+    u.phone_number_ = reader.String();
+    u.password_hash_ = reader.String();
+    u.salt_ = reader.String();
+    if (flags & kHasUsername) u.username_ = reader.String();
+    if (flags & kHasEmail) u.email_ = reader.String();
+    if (flags & kHasAvatar) u.avatar_url_ = reader.String();
+
+    // 尾部有多余字节同样视为损坏
+    if (!reader.Ok() || !reader.AtEnd()) {
+        return std::nullopt;
+    }
+    return u;
+}
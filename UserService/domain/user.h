@@ -5,6 +5,7 @@
 #include <string>
 #include <optional>
 #include <chrono>
+#include <string_view>
 #include <format>
 #include <nlohmann/json.hpp>
 
@@ -52,6 +53,19 @@ namespace user_service::domain {
         [[nodiscard]] nlohmann::json ToJson() const;
         static std::optional<User> FromJson(const nlohmann::json& json);
 
+        /*
+         * 紧凑二进制编码 (缓存用)，小端序：
+         *   magic(1) version(1) status(int16) flags(1) created_at(int64 微秒) [deleted_at(int64 微秒)]
+         *   id phone pwd_hash salt [username] [email] [avatar]，字符串均为 varint 长度 + 原始字节
+         * flags 的低 4 位依次标记 username/email/avatar/deleted_at 是否存在
+         * 首字节不可能是 '{'，据此与旧的 JSON 缓存区分
+         */
+        static constexpr uint8_t kBinaryMagic = 0xB5;
+        static constexpr uint8_t kBinaryVersion = 1;
+        [[nodiscard]] std::string ToBinary() const;
+        // 数据截断、版本不符时返回 nullopt
+        static std::optional<User> FromBinary(std::string_view data);
+
         // 只读
         [[nodiscard]] const std::string &GetId() const { return id_; }
         [[nodiscard]] const std::string &GetPhoneNumber() const { return phone_number_; }
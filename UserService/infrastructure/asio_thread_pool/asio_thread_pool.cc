@@ -3,11 +3,29 @@
 
 #include "asio_thread_pool.h"
 #include <spdlog/spdlog.h>
+#include "infrastructure/cpu_affinity/cpu_affinity.h"
 
 using namespace user_service::infrastructure;
 
-AsioThreadPool::AsioThreadPool(const std::shared_ptr<boost::asio::io_context>& ioc): ioc_(ioc) {
+namespace {
+    // 记录当前线程所属的 io_context 下标
+    thread_local std::optional<size_t> tls_context_index;
+}
+
+AsioThreadPool::AsioThreadPool(const std::shared_ptr<boost::asio::io_context>& ioc, const ThreadPoolConfig& config):
+    model_(config.model),
+    thread_count_(config.thread_count > 0 ? static_cast<unsigned>(config.thread_count) : GetCpuCoreCount()) {
     SPDLOG_DEBUG("Execute AsioThreadPool Constructor");
+    contexts_.push_back(ioc);
+    if (model_ == ExecutorModel::PerCore) {
+        /*
+         * 每个 io_context 只由一个线程 run，并发度提示为 1：asio 据此做一些单线程优化 (如完成的操作直接进线程私有队列)，
+         * 调度器的锁仍然保留 (其他线程向它投递时必须加锁)，只有 BOOST_ASIO_CONCURRENCY_HINT_UNSAFE 才会去掉
+         */
+        for (unsigned i = 1; i < thread_count_; ++i) {
+            contexts_.push_back(std::make_shared<boost::asio::io_context>(1));
+        }
+    }
 }
 
 AsioThreadPool::~AsioThreadPool() {
@@ -15,42 +33,58 @@ AsioThreadPool::~AsioThreadPool() {
     Stop();
 }
 
+std::optional<size_t> AsioThreadPool::CurrentIndex() {
+    return tls_context_index;
+}
+
 void AsioThreadPool::Run() {
     // 保证幂等
-    if (work_guard_) {
+    if (!work_guards_.empty()) {
         SPDLOG_WARN("AsioThreadPool is already running.");
         return;
     }
 
     // 创建 work_guard，防止 ioc->run() 没有任务就立即退出
-    work_guard_.emplace(boost::asio::make_work_guard(*ioc_));
-
-    unsigned int thread_count = std::thread::hardware_concurrency();
-    if (thread_count == 0) thread_count = 2; // 保底 2 个线程
-    // unsigned int thread_count = 1;
-    asio_threads_.reserve(thread_count);
-    for (unsigned i = 0; i < thread_count; ++i) {
-        asio_threads_.emplace_back([ioc = ioc_]() {
-            SPDLOG_TRACE("start run");
-            ioc->run();
-            SPDLOG_TRACE("finish run");
-        });
+    work_guards_.reserve(contexts_.size());
+    for (const auto& ctx : contexts_) {
+        work_guards_.emplace_back(boost::asio::make_work_guard(*ctx));
     }
-    SPDLOG_INFO("Asio thread pool started with {} threads.", thread_count);
+
+    asio_threads_.reserve(thread_count_);
+    for (unsigned i = 0; i < thread_count_; ++i) {
+        if (model_ == ExecutorModel::PerCore) {
+            // 一个线程独占一个 io_context，并与同序号的 CQ 轮询线程绑定到同一个核心
+            asio_threads_.emplace_back([ioc = contexts_[i], i]() {
+                PinCurrentThreadToCpu(i);
+                tls_context_index = i;
+                ioc->run();
+            });
+        } else {
+            asio_threads_.emplace_back([ioc = contexts_.front()]() {
+                SPDLOG_TRACE("start run");
+                tls_context_index = 0;
+                ioc->run();
+                SPDLOG_TRACE("finish run");
+            });
+        }
+    }
+    SPDLOG_INFO("Asio thread pool started with {} threads, {} io_context(s).", thread_count_, contexts_.size());
 }
 
 // 停止线程池
 void AsioThreadPool::Stop() {
     // 保证幂等
-    if (!work_guard_) {
+    if (work_guards_.empty()) {
         return;
     }
     SPDLOG_DEBUG("Stopping Asio thread pool...");
 
     // 释放 work_guard，允许 ioc->run() 退出
-    work_guard_.reset();
-    if (ioc_ && !ioc_->stopped()) {
-        ioc_->stop();
+    work_guards_.clear();
+    for (const auto& ctx : contexts_) {
+        if (!ctx->stopped()) {
+            ctx->stop();
+        }
     }
     // 等待所有线程退出
     for (auto& t : asio_threads_) {
@@ -60,4 +94,4 @@ void AsioThreadPool::Stop() {
     }
     asio_threads_.clear();
     SPDLOG_INFO("Asio thread pool stopped.");
-}
\ No newline at end of file
+}
@@ -9,19 +9,53 @@
 #include <optional>
 
 namespace user_service::infrastructure {
+    // 执行器模型
+    enum class ExecutorModel {
+        Shared,     // 所有线程共同 run 同一个 io_context (全局调度队列)
+        PerCore     // 每个线程独占一个 io_context 并绑核，任务在核内完成
+    };
+
+    // 配置文件
+    struct ThreadPoolConfig {
+        ExecutorModel model;
+        int thread_count;
+    };
+
     class AsioThreadPool {
     public:
         using work_guard_type = boost::asio::executor_work_guard<boost::asio::io_context::executor_type>;
-        AsioThreadPool(const std::shared_ptr<boost::asio::io_context>& ioc);
+        AsioThreadPool(const std::shared_ptr<boost::asio::io_context>& ioc, const ThreadPoolConfig& config);
         ~AsioThreadPool();
 
         // 启动和停止一定是幂等的
         void Run();
         void Stop();
 
+        [[nodiscard]] ExecutorModel GetModel() const { return model_; }
+
+        // io_context 数目：Shared 模式下为 1，PerCore 模式下等于线程数
+        [[nodiscard]] size_t Size() const { return contexts_.size(); }
+
+        // 线程数
+        [[nodiscard]] size_t ThreadCount() const { return thread_count_; }
+
+        // 下标超出时取模，方便调用方直接传入 CQ 分片号/连接序号
+        [[nodiscard]] const std::shared_ptr<boost::asio::io_context>& GetIOContext(const size_t index) const {
+            return contexts_[index % contexts_.size()];
+        }
+        [[nodiscard]] const std::vector<std::shared_ptr<boost::asio::io_context>>& GetIOContexts() const {
+            return contexts_;
+        }
+
+        // 当前线程所 run 的 io_context 下标，非本线程池线程返回 nullopt
+        [[nodiscard]] static std::optional<size_t> CurrentIndex();
+
     private:
-        const std::shared_ptr<boost::asio::io_context> ioc_;
-        std::optional<work_guard_type> work_guard_;
+        const ExecutorModel model_;
+        const unsigned thread_count_;
+        // contexts_[0] 始终是外部注入的共享 io_context
+        std::vector<std::shared_ptr<boost::asio::io_context>> contexts_;
+        std::vector<work_guard_type> work_guards_;
         std::vector<std::thread> asio_threads_;
     };
-}
\ No newline at end of file
+}
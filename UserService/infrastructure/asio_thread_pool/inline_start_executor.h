@@ -0,0 +1,72 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#pragma once
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/execution.hpp>
+#include <boost/asio/require.hpp>
+#include <atomic>
+#include <utility>
+
+namespace user_service::infrastructure {
+    /*
+     * 就地启动执行器：包装 io_context 的执行器，只改变第一次 dispatch 的语义
+     *  1. 第一次 dispatch (blocking.possibly) 在当前线程就地执行，即使当前线程并没有在 run 这个 io_context
+     *  2. 之后的 dispatch 交给 io_context 的执行器：当前线程正在 run 它时就地执行，否则投递
+     *  3. post (blocking.never) 总是投递到 io_context 的队列
+     *
+     * 用于 co_spawn：asio 以 dispatch 启动协程的第一步，所以协程会直接在 CQ 轮询线程上开始运行，
+     * 直到第一次真正挂起；省去了启动时投递到 io_context 的一次线程切换和一次队列往返。
+     * 这个执行器会一直作为协程的执行器，若每次 dispatch 都就地执行，之后的恢复会跑在完成 I/O 的线程上
+     * (Redis 连接的 strand、其他核心的 io_context)，所以就地执行只能有一次，标志由调用方持有，所有拷贝共享
+     *
+     * 注意：协程第一次挂起前的代码都跑在 CQ 线程上，只适合挂起前没有重计算的 RPC
+     */
+    class InlineStartExecutor {
+    public:
+        using inner_executor_type = boost::asio::io_context::executor_type;
+
+        // start_pending 为 true 时下一次 dispatch 就地执行并将其清零，须在协程结束前保持有效
+        InlineStartExecutor(const inner_executor_type& inner, std::atomic<bool>* start_pending) noexcept
+            : inner_(inner), start_pending_(start_pending) {}
+
+        // 所属的执行上下文
+        [[nodiscard]] boost::asio::io_context& query(boost::asio::execution::context_t) const noexcept {
+            return inner_.context();
+        }
+
+        static constexpr boost::asio::execution::blocking_t query(boost::asio::execution::blocking_t) noexcept {
+            return boost::asio::execution::blocking.possibly;
+        }
+
+        // 要求不可阻塞 (post) 时，直接退化为 io_context 自身的执行器
+        [[nodiscard]] auto require(boost::asio::execution::blocking_t::never_t) const noexcept {
+            return boost::asio::require(inner_, boost::asio::execution::blocking.never);
+        }
+
+        [[nodiscard]] InlineStartExecutor require(boost::asio::execution::blocking_t::possibly_t) const noexcept {
+            return *this;
+        }
+
+        template<typename Function>
+        void execute(Function&& f) const {
+            if (start_pending_->exchange(false, std::memory_order_acq_rel)) {
+                std::forward<Function>(f)();
+            } else {
+                inner_.execute(std::forward<Function>(f));
+            }
+        }
+
+        friend bool operator==(const InlineStartExecutor& a, const InlineStartExecutor& b) noexcept {
+            return a.inner_ == b.inner_ && a.start_pending_ == b.start_pending_;
+        }
+
+        friend bool operator!=(const InlineStartExecutor& a, const InlineStartExecutor& b) noexcept {
+            return !(a == b);
+        }
+
+    private:
+        inner_executor_type inner_;
+        std::atomic<bool>* start_pending_;
+    };
+}
@@ -0,0 +1,102 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+
+namespace user_service::infrastructure {
+    /*
+     * 有界无锁多生产者多消费者队列 (Dmitry Vyukov 算法)
+     * 每个槽位带一个序号：
+     *  - 序号 == 位置        代表槽位空闲，可写
+     *  - 序号 == 位置 + 1    代表槽位已写入，可读
+     * 生产者/消费者各自只用一次 CAS 抢占位置，不存在全局锁
+     */
+    template<typename T>
+    class MpmcQueue {
+    public:
+        explicit MpmcQueue(const size_t capacity) : capacity_(std::bit_ceil(capacity < 2 ? size_t{2} : capacity)),
+            mask_(capacity_ - 1), slots_(std::make_unique<Slot[]>(capacity_)) {
+            for (size_t i = 0; i < capacity_; ++i) {
+                slots_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MpmcQueue(const MpmcQueue&) = delete;
+        MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+        // 队列满返回 false
+        bool TryPush(T value) {
+            size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+            Slot* slot;
+            while (true) {
+                slot = &slots_[pos & mask_];
+                const size_t seq = slot->sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+                if (diff == 0) {
+                    // 槽位空闲，尝试占用
+                    if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    // 槽位还没被消费，队列已满
+                    return false;
+                } else {
+                    // 被其他生产者抢先，重新读取位置
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+            slot->value = std::move(value);
+            slot->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 队列空返回 nullopt
+        std::optional<T> TryPop() {
+            size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+            Slot* slot;
+            while (true) {
+                slot = &slots_[pos & mask_];
+                const size_t seq = slot->sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+                if (diff == 0) {
+                    if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    // 槽位还没写入，队列为空
+                    return std::nullopt;
+                } else {
+                    pos = dequeue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+            std::optional<T> value(std::move(slot->value));
+            // 标记槽位可被下一轮 (pos + capacity) 的生产者写入
+            slot->sequence.store(pos + mask_ + 1, std::memory_order_release);
+            return value;
+        }
+
+        [[nodiscard]] size_t Capacity() const { return capacity_; }
+
+    private:
+        // 按缓存行对齐，避免伪共享
+        static constexpr size_t kCacheLine = 64;
+
+        struct alignas(kCacheLine) Slot {
+            std::atomic<size_t> sequence;
+            T value{};
+        };
+
+        const size_t capacity_;
+        const size_t mask_;
+        std::unique_ptr<Slot[]> slots_;
+        alignas(kCacheLine) std::atomic<size_t> enqueue_pos_{0};
+        alignas(kCacheLine) std::atomic<size_t> dequeue_pos_{0};
+    };
+}
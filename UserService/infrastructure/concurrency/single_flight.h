@@ -0,0 +1,83 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#pragma once
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/asio/experimental/concurrent_channel.hpp>
+
+namespace user_service::infrastructure {
+    /*
+     * 同一个 key 的并发加载只执行一次
+     * 第一个调用者 (leader) 执行 loader，期间到达的调用者挂起等待，leader 完成后所有人拿到同一份结果 (或同一个异常)
+     * 完成后立即从表中移除，不做缓存；可以在任意线程、任意执行器上调用
+     * Value 需要可拷贝
+     */
+    template<typename Key, typename Value, typename Hash = std::hash<Key>>
+    class SingleFlight {
+    public:
+        // loader: () -> boost::asio::awaitable<Value>
+        template<typename Loader>
+        boost::asio::awaitable<Value> Do(const Key& key, Loader&& loader) {
+            const auto executor = co_await boost::asio::this_coro::executor;
+            std::shared_ptr<Call> call;
+            bool is_leader = false;
+            {
+                std::lock_guard lock(mutex_);
+                auto [it, inserted] = calls_.try_emplace(key);
+                if (inserted) {
+                    it->second = std::make_shared<Call>(executor);
+                    is_leader = true;
+                }
+                call = it->second;
+            }
+
+            if (!is_leader) {
+                // leader 关闭 channel 即为广播，挂起中的和之后到达的 receive 都会以 channel_closed 完成
+                boost::system::error_code ec;
+                co_await call->done.async_receive(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+                co_return call->Get();
+            }
+
+            try {
+                call->value.emplace(co_await std::forward<Loader>(loader)());
+            } catch (...) {
+                call->exception = std::current_exception();
+            }
+            {
+                // 先移出表，再唤醒：之后到达的调用者会发起新的一轮加载
+                std::lock_guard lock(mutex_);
+                calls_.erase(key);
+            }
+            call->done.close();
+            co_return call->Get();
+        }
+
+    private:
+        struct Call {
+            template<typename Executor>
+            explicit Call(const Executor& executor) : done(executor, 1) {}
+
+            Value Get() const {
+                if (exception) {
+                    std::rethrow_exception(exception);
+                }
+                return *value;
+            }
+
+            std::optional<Value> value;
+            std::exception_ptr exception;
+            boost::asio::experimental::concurrent_channel<void(boost::system::error_code)> done;
+        };
+
+        std::mutex mutex_;
+        std::unordered_map<Key, std::shared_ptr<Call>, Hash> calls_;
+    };
+}
@@ -0,0 +1,29 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#include "infrastructure/cpu_affinity/cpu_affinity.h"
+#include <pthread.h>
+#include <sched.h>
+#include <thread>
+#include <spdlog/spdlog.h>
+
+namespace user_service::infrastructure {
+    unsigned GetCpuCoreCount() {
+        const unsigned hw_conc = std::thread::hardware_concurrency();
+        return hw_conc > 0 ? hw_conc : 2;
+    }
+
+    bool PinCurrentThreadToCpu(const unsigned cpu_index) {
+        const unsigned core = cpu_index % GetCpuCoreCount();
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(core, &cpu_set);
+        // 绑核失败（容器 cpuset 限制等）不影响正确性，降级为由内核调度
+        if (const int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set); rc != 0) {
+            SPDLOG_WARN("Failed to pin thread to cpu {}: error code {}", core, rc);
+            return false;
+        }
+        SPDLOG_DEBUG("Thread pinned to cpu {}", core);
+        return true;
+    }
+}
@@ -0,0 +1,12 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#pragma once
+
+namespace user_service::infrastructure {
+    // 获取可用 CPU 核心数（获取不到时兜底为 2）
+    unsigned GetCpuCoreCount();
+
+    // 将当前线程绑定到指定核心，cpu_index 超出核心数时取模；失败只打日志不抛异常
+    bool PinCurrentThreadToCpu(unsigned cpu_index);
+}
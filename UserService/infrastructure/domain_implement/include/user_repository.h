@@ -4,18 +4,41 @@
 #pragma once
 #include "domain/interface/i_user_repository.h"
 #include "infrastructure/persistence/dao/user_dao.h"
+#include "infrastructure/persistence/dao/user_batch_loader.h"
 #include "infrastructure/state_storage/redis_dao/redis_client.h"
+#include "infrastructure/concurrency/single_flight.h"
+#include "infrastructure/local_cache/sharded_lru_cache.h"
 
 namespace user_service::infrastructure {
+    // 进程内一级缓存：user id -> User
+    using UserLocalCache = ShardedLruCache<std::string, domain::User>;
+
     class UserRepository final : public domain::IUserRepository {
     public:
-        explicit UserRepository(const std::shared_ptr<UserDao>& user_dao, const std::shared_ptr<RedisClient>& redis_client);
+        explicit UserRepository(const std::shared_ptr<UserDao>& user_dao, const std::shared_ptr<UserBatchLoader>& user_batch_loader,
+                                const std::shared_ptr<RedisClient>& redis_client, const std::shared_ptr<UserLocalCache>& local_cache);
         ~UserRepository() override;
         boost::asio::awaitable<std::expected<void, DbError>> CreateUser(const domain::User& user) override;
         boost::asio::awaitable<std::expected<std::optional<domain::User>, DbError>> GetUserById(const std::string& id) override;
         boost::asio::awaitable<std::expected<std::optional<domain::User>, DbError>> GetUserByPhoneNumber(const std::string& phoneNumber) override;
+        boost::asio::awaitable<std::expected<std::vector<std::optional<domain::User>>, DbError>> GetUsersByIds(const std::vector<std::string>& ids) override;
+
+        [[nodiscard]] LocalCacheStats GetLocalCacheStats() const { return local_cache_->GetStats(); }
     private:
+        using UserResult = std::expected<std::optional<domain::User>, DbError>;
+
+        // 解码 Redis 中的缓存值：二进制格式优先，兼容旧的 JSON 格式，损坏返回 nullopt
+        static std::optional<domain::User> DecodeCachedUser(const std::string& value);
+
+        // 缓存未命中：查库并回填缓存
+        boost::asio::awaitable<UserResult> LoadUserAndPopulateCache(const std::string& id);
+
         const std::shared_ptr<UserDao> user_dao_;
+        const std::shared_ptr<UserBatchLoader> user_batch_loader_;
         const std::shared_ptr<RedisClient> redis_client_;
+        // 一级缓存，命中时不访问 Redis
+        const std::shared_ptr<UserLocalCache> local_cache_;
+        // 同一个用户的并发未命中只回源一次，防止热点 key 过期时击穿数据库
+        SingleFlight<std::string, UserResult> user_flight_;
     };
 }
@@ -2,16 +2,37 @@
 // Licensed under the MIT License.
 
 #include "../include/user_repository.h"
+#include <unordered_map>
+#include <unordered_set>
 
 using namespace user_service::infrastructure;
 using namespace user_service::domain;
 
-UserRepository::UserRepository(const std::shared_ptr<UserDao>& user_dao, const std::shared_ptr<RedisClient>& redis_client):
-    user_dao_(user_dao), redis_client_(redis_client) {
+namespace {
+    constexpr std::string_view kUserCacheKeyPrefix = "user:info:";
+    constexpr std::chrono::seconds kUserCacheTtl{3600};
+
+    std::string UserCacheKey(const std::string& id) {
+        std::string key;
+        key.reserve(kUserCacheKeyPrefix.size() + id.size());
+        key.append(kUserCacheKeyPrefix).append(id);
+        return key;
+    }
+}
+
+UserRepository::UserRepository(const std::shared_ptr<UserDao>& user_dao, const std::shared_ptr<UserBatchLoader>& user_batch_loader,
+                               const std::shared_ptr<RedisClient>& redis_client, const std::shared_ptr<UserLocalCache>& local_cache):
+    user_dao_(user_dao), user_batch_loader_(user_batch_loader), redis_client_(redis_client), local_cache_(local_cache) {
 
 }
 
-UserRepository::~UserRepository() = default;
+UserRepository::~UserRepository() {
+    if (local_cache_->Enabled()) {
+        const auto stats = local_cache_->GetStats();
+        SPDLOG_INFO("User local cache stats. Hits: {}, Misses: {}, Evictions: {}, Expirations: {}, Size: {}",
+            stats.hits, stats.misses, stats.evictions, stats.expirations, stats.size);
+    }
+}
 
 boost::asio::awaitable<std::expected<void, DbError>> UserRepository::CreateUser(const User& user) {
     co_return co_await user_dao_->CreateUser(user);
@@ -31,7 +52,12 @@ boost::asio::awaitable<std::expected<std::optional<User>, DbError>> UserReposito
     //     "https://oss.example.com/avatars/default.png" // avatar_url
     // );
     // co_return std::optional<user_service::domain::User>(std::move(mock_user));
-    const std::string cache_key = "user:info:" + id;
+    // 先查进程内缓存
+    if (auto local_user = local_cache_->Get(id); local_user.has_value()) {
+        co_return std::move(local_user);
+    }
+
+    const std::string cache_key = UserCacheKey(id);
 
     // 尝试读缓存
     const auto redis_res = co_await redis_client_->Get(cache_key);
@@ -40,15 +66,11 @@ boost::asio::awaitable<std::expected<std::optional<User>, DbError>> UserReposito
         const auto& opt_val = redis_res.value();
 
         if (opt_val.has_value()) {  // 缓存命中
-            // 使用不抛异常的 parse 接口
-            // 参数2: callback=nullptr, 参数3: allow_exceptions=false
-            nlohmann::json j = nlohmann::json::parse(opt_val.value(), nullptr, false);
-            if (!j.is_discarded()) {
-                auto user_opt = User::FromJson(j); // User::FromJson 内部处理了字段缺失异常
-                if (user_opt.has_value()) {
-                    SPDLOG_DEBUG("Cache HIT for user: {}", id);
-                    co_return user_opt;
-                }
+            auto user_opt = DecodeCachedUser(opt_val.value());
+            if (user_opt.has_value()) {
+                SPDLOG_DEBUG("Cache HIT for user: {}", id);
+                local_cache_->Put(id, user_opt.value());
+                co_return user_opt;
             }
             // 解析失败（数据损坏或版本不兼容），当做缓存未命中
             SPDLOG_WARN("Cache invalid for user: {}, refreshing from DB", id);
@@ -58,8 +80,15 @@ boost::asio::awaitable<std::expected<std::optional<User>, DbError>> UserReposito
         SPDLOG_WARN("Redis error ignored in GetUserById: {}", redis_res.error().message);
     }
 
-    // 缓存未命中，查数据库
-    auto db_result_exp = co_await user_dao_->GetUserById(id);
+    // 缓存未命中：同一个 id 的并发请求只有第一个真正回源，其余等待它的结果
+    co_return co_await user_flight_.Do(id, [this, &id] { return LoadUserAndPopulateCache(id); });
+}
+
+boost::asio::awaitable<UserRepository::UserResult> UserRepository::LoadUserAndPopulateCache(const std::string& id) {
+    const std::string cache_key = UserCacheKey(id);
+
+    // 查数据库 (不同 id 的并发未命中会被合并成一次批量查询)
+    auto db_result_exp = co_await user_batch_loader_->Load(id);
 
     // DB 出错直接返回
     if (!db_result_exp.has_value()) {
@@ -70,12 +99,13 @@ boost::asio::awaitable<std::expected<std::optional<User>, DbError>> UserReposito
 
     // 查库成功，回填缓存
     if (user_opt.has_value()) {
+        local_cache_->Put(id, user_opt.value());
         try {
-            // ToJson().dump() 可能会因为内存耗尽抛异常，防一下比较稳妥
-            const std::string json_str = user_opt.value().ToJson().dump();
+            // 编码可能会因为内存耗尽抛异常，防一下比较稳妥
+            const std::string encoded = user_opt.value().ToBinary();
 
             // Set 现在返回 expected，不会抛网络异常了
-            const auto set_res = co_await redis_client_->Set(cache_key, json_str, std::chrono::seconds(3600));
+            const auto set_res = co_await redis_client_->Set(cache_key, encoded, kUserCacheTtl);
 
             if (!set_res.has_value()) {
                 SPDLOG_WARN("Failed to populate cache for user {}: {}", id, set_res.error().message);
@@ -83,13 +113,127 @@ boost::asio::awaitable<std::expected<std::optional<User>, DbError>> UserReposito
                 SPDLOG_DEBUG("Cache MISS. Populated redis for user: {}", id);
             }
         } catch (const std::exception& e) {
-            // 仅捕获 JSON 序列化可能的异常
+            // 仅捕获序列化可能的异常
             SPDLOG_WARN("Serialization failed for user {}: {}", id, e.what());
         }
     }
     co_return db_result_exp;
 }
 
+boost::asio::awaitable<std::expected<std::vector<std::optional<User>>, DbError>> UserRepository::GetUsersByIds(
+    const std::vector<std::string>& ids) {
+    std::vector<std::optional<User>> users(ids.size());
+
+    // 1. 进程内缓存
+    std::vector<size_t> missing;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (auto local_user = local_cache_->Get(ids[i]); local_user.has_value()) {
+            users[i] = std::move(local_user);
+        } else {
+            missing.push_back(i);
+        }
+    }
+    if (missing.empty()) {
+        co_return users;
+    }
+
+    // 2. Redis 一次 MGET
+    std::vector<std::string> cache_keys;
+    cache_keys.reserve(missing.size());
+    for (const size_t i : missing) {
+        cache_keys.push_back(UserCacheKey(ids[i]));
+    }
+    std::vector<size_t> db_missing;
+    const auto redis_res = co_await redis_client_->MGet(cache_keys);
+    if (redis_res.has_value()) {
+        const auto& values = redis_res.value();
+        for (size_t j = 0; j < missing.size(); ++j) {
+            const size_t i = missing[j];
+            if (values[j].has_value()) {
+                if (auto user_opt = DecodeCachedUser(values[j].value()); user_opt.has_value()) {
+                    local_cache_->Put(ids[i], user_opt.value());
+                    users[i] = std::move(user_opt);
+                    continue;
+                }
+            }
+            db_missing.push_back(i);
+        }
+    } else {
+        // 降级：全部查库
+        SPDLOG_WARN("Redis error ignored in GetUsersByIds: {}", redis_res.error().message);
+        db_missing = std::move(missing);
+    }
+    if (db_missing.empty()) {
+        co_return users;
+    }
+
+    // 3. 查库：合法 uuid 去重后一次批量查询，其余逐条查询
+    std::vector<std::string> batch_ids;
+    std::vector<std::string> single_ids;
+    std::unordered_set<std::string> seen;
+    for (const size_t i : db_missing) {
+        if (!seen.insert(ids[i]).second) {
+            continue;
+        }
+        if (UserBatchLoader::IsUuidText(ids[i])) {
+            batch_ids.push_back(ids[i]);
+        } else {
+            single_ids.push_back(ids[i]);
+        }
+    }
+    std::unordered_map<std::string, User> found;
+    auto db_res = co_await user_dao_->GetUsersByIds(batch_ids);
+    if (!db_res.has_value()) {
+        co_return std::unexpected(db_res.error());
+    }
+    for (auto& user : db_res.value()) {
+        std::string id = user.GetId();
+        found.emplace(std::move(id), std::move(user));
+    }
+    for (const auto& id : single_ids) {
+        auto single_res = co_await user_dao_->GetUserById(id);
+        if (!single_res.has_value()) {
+            co_return std::unexpected(single_res.error());
+        }
+        if (single_res.value().has_value()) {
+            found.emplace(id, std::move(single_res.value().value()));
+        }
+    }
+
+    // 4. 回填：一次流水线写入 Redis
+    for (const size_t i : db_missing) {
+        if (const auto it = found.find(ids[i]); it != found.end()) {
+            users[i] = it->second;
+        }
+    }
+    std::vector<RedisSetEntry> entries;
+    entries.reserve(found.size());
+    for (const auto& [id, user] : found) {
+        local_cache_->Put(id, user);
+        entries.push_back(RedisSetEntry{UserCacheKey(id), user.ToBinary(), kUserCacheTtl});
+    }
+    if (!entries.empty()) {
+        const auto set_res = co_await redis_client_->MSet(entries);
+        if (!set_res.has_value()) {
+            SPDLOG_WARN("Failed to populate cache for {} users: {}", entries.size(), set_res.error().message);
+        }
+    }
+    co_return users;
+}
+
+std::optional<User> UserRepository::DecodeCachedUser(const std::string& value) {
+    if (!value.empty() && static_cast<uint8_t>(value.front()) == User::kBinaryMagic) {
+        return User::FromBinary(value);
+    }
+    // 兼容升级前写入的 JSON 缓存，这些条目过期或被回填后自然替换为二进制格式
+    // 使用不抛异常的 parse 接口，参数2: callback=nullptr, 参数3: allow_exceptions=false
+    const nlohmann::json j = nlohmann::json::parse(value, nullptr, false);
+    if (j.is_discarded()) {
+        return std::nullopt;
+    }
+    return User::FromJson(j); // User::FromJson 内部处理了字段缺失异常
+}
+
 boost::asio::awaitable<std::expected<std::optional<User>, DbError>> UserRepository::GetUserByPhoneNumber(const std::string& phoneNumber) {
     co_return co_await user_dao_->GetUserByPhoneNumber(phoneNumber);
 }
\ No newline at end of file
@@ -0,0 +1,168 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#pragma once
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace user_service::infrastructure {
+    // 配置文件
+    struct LocalCacheConfig {
+        bool enabled;
+        size_t max_entries;             // 总条目上限，平均分到各分片
+        std::chrono::milliseconds ttl;  // 写入后多久过期，本地缓存没有失效通知，过期时间决定了最大不一致窗口
+        size_t shard_count;             // 分片数，向上取整为 2 的幂
+    };
+
+    struct LocalCacheStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;     // 容量淘汰
+        uint64_t expirations = 0;   // 过期淘汰
+        size_t size = 0;
+    };
+
+    /*
+     * 进程内分片 LRU + TTL 缓存
+     * key 按哈希分到各分片，每个分片一把锁、一条 LRU 链表，不同分片之间互不争用
+     * 计数器放在分片内部 (按缓存行对齐)，读统计时再汇总
+     */
+    template<typename Key, typename Value, typename Hash = std::hash<Key>>
+    class ShardedLruCache {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        explicit ShardedLruCache(const LocalCacheConfig& config)
+            : enabled_(config.enabled && config.max_entries > 0),
+              shard_count_(std::bit_ceil(std::max<size_t>(config.shard_count, 1))),
+              shard_bits_(std::countr_zero(shard_count_)),
+              per_shard_capacity_(std::max<size_t>(config.max_entries / shard_count_, 1)),
+              ttl_(config.ttl),
+              shards_(std::make_unique<Shard[]>(shard_count_)) {
+        }
+
+        [[nodiscard]] bool Enabled() const { return enabled_; }
+
+        std::optional<Value> Get(const Key& key) {
+            if (!enabled_) {
+                return std::nullopt;
+            }
+            Shard& shard = ShardFor(key);
+            std::lock_guard lock(shard.mutex);
+            const auto it = shard.index.find(key);
+            if (it == shard.index.end()) {
+                shard.misses.fetch_add(1, std::memory_order_relaxed);
+                return std::nullopt;
+            }
+            if (Clock::now() >= it->second->expire_at) {
+                shard.lru.erase(it->second);
+                shard.index.erase(it);
+                shard.expirations.fetch_add(1, std::memory_order_relaxed);
+                shard.misses.fetch_add(1, std::memory_order_relaxed);
+                return std::nullopt;
+            }
+            // 移到链表头 (最近使用)
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            shard.hits.fetch_add(1, std::memory_order_relaxed);
+            return it->second->value;
+        }
+
+        void Put(const Key& key, Value value) {
+            if (!enabled_) {
+                return;
+            }
+            Shard& shard = ShardFor(key);
+            const auto expire_at = Clock::now() + ttl_;
+            std::lock_guard lock(shard.mutex);
+            if (const auto it = shard.index.find(key); it != shard.index.end()) {
+                it->second->value = std::move(value);
+                it->second->expire_at = expire_at;
+                shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+                return;
+            }
+            if (shard.lru.size() >= per_shard_capacity_) {
+                // 淘汰链表尾 (最久未使用)
+                shard.index.erase(shard.lru.back().key);
+                shard.lru.pop_back();
+                shard.evictions.fetch_add(1, std::memory_order_relaxed);
+            }
+            shard.lru.push_front(Entry{key, std::move(value), expire_at});
+            shard.index.emplace(key, shard.lru.begin());
+        }
+
+        void Erase(const Key& key) {
+            if (!enabled_) {
+                return;
+            }
+            Shard& shard = ShardFor(key);
+            std::lock_guard lock(shard.mutex);
+            if (const auto it = shard.index.find(key); it != shard.index.end()) {
+                shard.lru.erase(it->second);
+                shard.index.erase(it);
+            }
+        }
+
+        void Clear() {
+            for (size_t i = 0; i < shard_count_; ++i) {
+                std::lock_guard lock(shards_[i].mutex);
+                shards_[i].lru.clear();
+                shards_[i].index.clear();
+            }
+        }
+
+        [[nodiscard]] LocalCacheStats GetStats() const {
+            LocalCacheStats stats;
+            for (size_t i = 0; i < shard_count_; ++i) {
+                const Shard& shard = shards_[i];
+                stats.hits += shard.hits.load(std::memory_order_relaxed);
+                stats.misses += shard.misses.load(std::memory_order_relaxed);
+                stats.evictions += shard.evictions.load(std::memory_order_relaxed);
+                stats.expirations += shard.expirations.load(std::memory_order_relaxed);
+                std::lock_guard lock(shard.mutex);
+                stats.size += shard.lru.size();
+            }
+            return stats;
+        }
+
+    private:
+        struct Entry {
+            Key key;
+            Value value;
+            Clock::time_point expire_at;
+        };
+
+        struct alignas(64) Shard {
+            mutable std::mutex mutex;
+            // 表头为最近使用
+            std::list<Entry> lru;
+            std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> index;
+            std::atomic<uint64_t> hits{0};
+            std::atomic<uint64_t> misses{0};
+            std::atomic<uint64_t> evictions{0};
+            std::atomic<uint64_t> expirations{0};
+        };
+
+        Shard& ShardFor(const Key& key) {
+            if (shard_bits_ == 0) {
+                return shards_[0];
+            }
+            // 取乘法散列的高位选分片，避免与 unordered_map 按低位分桶相关
+            const uint64_t mixed = static_cast<uint64_t>(Hash{}(key)) * 0x9E3779B97F4A7C15ULL;
+            return shards_[mixed >> (64 - shard_bits_)];
+        }
+
+        const bool enabled_;
+        const size_t shard_count_;
+        const int shard_bits_;
+        const size_t per_shard_capacity_;
+        const std::chrono::milliseconds ttl_;
+        std::unique_ptr<Shard[]> shards_;
+    };
+}
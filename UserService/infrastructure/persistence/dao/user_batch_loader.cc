@@ -0,0 +1,117 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#include "infrastructure/persistence/dao/user_batch_loader.h"
+#include "infrastructure/asio_thread_pool/asio_thread_pool.h"
+#include <algorithm>
+#include <unordered_map>
+#include <spdlog/spdlog.h>
+
+using namespace user_service::infrastructure;
+using namespace user_service::domain;
+
+UserBatchLoader::UserBatchLoader(const std::shared_ptr<UserDao>& user_dao, const std::shared_ptr<AsioThreadPool>& thread_pool,
+                                 const UserBatchConfig& config)
+    : user_dao_(user_dao),
+      window_(config.window),
+      max_batch_size_(std::max<size_t>(config.max_batch_size, 1)),
+      strand_(boost::asio::make_strand(*thread_pool->GetIOContext(0))),
+      timer_(strand_) {
+}
+
+boost::asio::awaitable<std::expected<std::optional<User>, DbError>> UserBatchLoader::Load(const std::string& id) {
+    if (window_.count() == 0 || !IsUuidText(id)) {
+        co_return co_await user_dao_->GetUserById(id);
+    }
+    const auto pending = co_await boost::asio::co_spawn(strand_, EnqueueOnStrand(id), boost::asio::use_awaitable);
+    if (pending->exception) {
+        std::rethrow_exception(pending->exception);
+    }
+    co_return std::move(*pending->result);
+}
+
+boost::asio::awaitable<std::shared_ptr<UserBatchLoader::PendingLoad>> UserBatchLoader::EnqueueOnStrand(std::string id) {
+    auto pending = std::make_shared<PendingLoad>(strand_, std::move(id));
+    batch_.push_back(pending);
+    if (batch_.size() >= max_batch_size_) {
+        FlushOnStrand();
+    } else if (batch_.size() == 1) {
+        // 批次的第一个请求开启窗口；定时器绑定在 strand 上，回调也在 strand 上执行
+        timer_.expires_after(window_);
+        timer_.async_wait([self = shared_from_this()](const boost::system::error_code& ec) {
+            // 被 cancel 说明批次已因攒满提前发出
+            if (!ec) {
+                self->FlushOnStrand();
+            }
+        });
+    }
+    co_await pending->done.async_receive(boost::asio::use_awaitable);
+    co_return pending;
+}
+
+void UserBatchLoader::FlushOnStrand() {
+    if (batch_.empty()) {
+        return;
+    }
+    timer_.cancel();
+    auto batch = std::move(batch_);
+    batch_.clear();
+    boost::asio::co_spawn(strand_, RunBatch(std::move(batch)), boost::asio::detached);
+}
+
+boost::asio::awaitable<void> UserBatchLoader::RunBatch(std::vector<std::shared_ptr<PendingLoad>> batch) {
+    const auto self = shared_from_this();
+    // 同一批次里相同 ID 只查一次
+    std::unordered_map<std::string, std::optional<User>> found;
+    std::vector<std::string> ids;
+    ids.reserve(batch.size());
+    for (const auto& pending : batch) {
+        if (found.try_emplace(pending->id).second) {
+            ids.push_back(pending->id);
+        }
+    }
+    SPDLOG_DEBUG("Coalesced {} GetUserById request(s) into one query for {} id(s)", batch.size(), ids.size());
+
+    std::optional<std::expected<std::vector<User>, DbError>> users_exp;
+    std::exception_ptr exception;
+    try {
+        users_exp = co_await user_dao_->GetUsersByIds(ids);
+    } catch (...) {
+        exception = std::current_exception();
+    }
+
+    if (users_exp && users_exp->has_value()) {
+        for (auto& user : users_exp->value()) {
+            if (auto it = found.find(user.GetId()); it != found.end()) {
+                it->second = std::move(user);
+            }
+        }
+    }
+
+    for (const auto& pending : batch) {
+        if (exception) {
+            pending->exception = exception;
+        } else if (!users_exp->has_value()) {
+            pending->result = std::unexpected(users_exp->error());
+        } else {
+            pending->result = found[pending->id];
+        }
+        pending->done.try_send(boost::system::error_code{});
+    }
+}
+
+bool UserBatchLoader::IsUuidText(const std::string& id) {
+    // 只接受小写：结果按数据库返回的 id (小写文本) 匹配回请求
+    if (id.size() != 36) {
+        return false;
+    }
+    for (size_t i = 0; i < id.size(); ++i) {
+        const char c = id[i];
+        if (i == 8 || i == 13 || i == 18 || i == 23) {
+            if (c != '-') return false;
+        } else if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,65 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#pragma once
+#include "infrastructure/persistence/dao/user_dao.h"
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <vector>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/experimental/channel.hpp>
+
+namespace user_service::infrastructure {
+    class AsioThreadPool;
+
+    // 配置文件
+    struct UserBatchConfig {
+        std::chrono::microseconds window;   // 攒批窗口，0 代表关闭合并，直接逐条查询
+        size_t max_batch_size;              // 攒够这么多个 ID 立即发出
+    };
+
+    /*
+     * GetUserById 请求合并
+     * 第一个请求到达后开启一个短窗口，窗口内到达的请求一起用 WHERE id = ANY($1) 查询，再把结果分发回各个协程。
+     * 批次状态只在 strand 上访问；查询期间 strand 空闲，下一批可以继续攒
+     */
+    class UserBatchLoader : public std::enable_shared_from_this<UserBatchLoader> {
+    public:
+        UserBatchLoader(const std::shared_ptr<UserDao>& user_dao, const std::shared_ptr<AsioThreadPool>& thread_pool,
+                        const UserBatchConfig& config);
+
+        boost::asio::awaitable<std::expected<std::optional<domain::User>, DbError>> Load(const std::string& id);
+
+        // 只有合法的 uuid 文本才能放进数组参数，否则整批都会因类型转换失败；其他 id 走单条查询
+        static bool IsUuidText(const std::string& id);
+
+    private:
+        struct PendingLoad {
+            PendingLoad(const boost::asio::strand<boost::asio::io_context::executor_type>& strand, std::string user_id)
+                : id(std::move(user_id)), done(strand, 1) {}
+            std::string id;
+            std::optional<std::expected<std::optional<domain::User>, DbError>> result;
+            // 批量查询抛出的异常原样转交给调用方
+            std::exception_ptr exception;
+            boost::asio::experimental::channel<void(boost::system::error_code)> done;
+        };
+
+        // 加入当前批次并等待结果 (运行在 strand 上)
+        boost::asio::awaitable<std::shared_ptr<PendingLoad>> EnqueueOnStrand(std::string id);
+
+        // 把当前批次交给 RunBatch (运行在 strand 上)
+        void FlushOnStrand();
+
+        boost::asio::awaitable<void> RunBatch(std::vector<std::shared_ptr<PendingLoad>> batch);
+
+        const std::shared_ptr<UserDao> user_dao_;
+        const std::chrono::microseconds window_;
+        const size_t max_batch_size_;
+
+        boost::asio::strand<boost::asio::io_context::executor_type> strand_;
+        boost::asio::steady_timer timer_;
+        std::vector<std::shared_ptr<PendingLoad>> batch_;
+    };
+}
@@ -2,12 +2,37 @@
 // Licensed under the MIT License.
 
 #include "infrastructure/persistence/dao/user_dao.h"
+#include "infrastructure/persistence/postgresql/include/pg_row_view.h"
 #include <spdlog/spdlog.h>
 
 using namespace user_service::infrastructure;
 using namespace user_service::domain;
 
-UserDao::UserDao(const std::shared_ptr<AsyncConnectionPool>& pool): pool_(pool) {
+namespace {
+    // 高频查询使用预编译语句，语句名在连接内唯一
+    constexpr PreparedStatement kSelectUserById{
+        "user_by_id",
+        "SELECT id, phone_number, username, email, password_hash, salt, avatar_url, status, created_at "
+        "FROM users WHERE id = $1 AND deleted_at IS NULL LIMIT 1"
+    };
+    constexpr PreparedStatement kSelectUsersByIds{
+        "users_by_ids",
+        "SELECT id, phone_number, username, email, password_hash, salt, avatar_url, status, created_at "
+        "FROM users WHERE id = ANY($1::uuid[]) AND deleted_at IS NULL"
+    };
+    constexpr PreparedStatement kSelectUserByPhone{
+        "user_by_phone",
+        "SELECT id, phone_number, username, email, password_hash, salt, avatar_url, status, created_at "
+        "FROM users WHERE phone_number = $1 AND deleted_at IS NULL LIMIT 1"
+    };
+    constexpr PreparedStatement kInsertUser{
+        "user_insert",
+        "INSERT INTO users (id, phone_number, username, email, password_hash, salt, avatar_url, status) "
+        "VALUES ($1, $2, $3, $4, $5, $6, $7, $8)"
+    };
+}
+
+UserDao::UserDao(const std::shared_ptr<IConnectionPool>& pool): pool_(pool) {
 
 }
 
@@ -16,9 +41,6 @@ UserDao::~UserDao() = default;
 boost::asio::awaitable<std::expected<void, DbError>> UserDao::CreateUser(const User& user) const {
     const auto conn = co_await pool_->GetConnection();
 
-    const std::string sql = "INSERT INTO users (id, phone_number, username, email, password_hash, salt, avatar_url, status) "
-                            "VALUES ($1, $2, $3, $4, $5, $6, $7, $8)";
-
     const std::vector<std::string> params = {
         user.GetId(),
         user.GetPhoneNumber(),
@@ -30,7 +52,7 @@ boost::asio::awaitable<std::expected<void, DbError>> UserDao::CreateUser(const U
         std::to_string(user.GetStatusValue())
     };
 
-    const auto result_exp = co_await conn->AsyncExecParams(sql, params);
+    const auto result_exp = co_await conn->AsyncExecPrepared(kInsertUser, params);
 
     if (!result_exp.has_value()) {
         co_return std::unexpected(result_exp.error());
@@ -42,11 +64,9 @@ boost::asio::awaitable<std::expected<std::optional<User>, DbError>> UserDao::Get
     SPDLOG_DEBUG("{}", id);
     const auto conn = co_await pool_->GetConnection();
 
-    const std::string sql = "SELECT id, phone_number, username, email, password_hash, salt, avatar_url, status, created_at "
-                            "FROM users WHERE id = $1 AND deleted_at IS NULL LIMIT 1";
     const std::vector<std::string> params = { id };
 
-    auto result_exp = co_await conn->AsyncExecParams(sql, params);
+    auto result_exp = co_await conn->AsyncExecPrepared(kSelectUserById, params, ResultFormat::Binary);
 
     if (!result_exp.has_value()) {
         co_return std::unexpected(result_exp.error());
@@ -61,13 +81,43 @@ boost::asio::awaitable<std::expected<std::optional<User>, DbError>> UserDao::Get
     co_return MapRowToUser(result_ptr.get(), 0);
 }
 
+boost::asio::awaitable<std::expected<std::vector<User>, DbError>> UserDao::GetUsersByIds(const std::vector<std::string>& ids) {
+    if (ids.empty()) {
+        co_return std::vector<User>{};
+    }
+    const auto conn = co_await pool_->GetConnection();
+
+    // 以数组字面量 {id1,id2,...} 作为单个参数传入 (调用方保证 id 是合法的 uuid 文本)
+    std::string id_array;
+    id_array.reserve(ids.size() * 37 + 2);
+    id_array.push_back('{');
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (i > 0) id_array.push_back(',');
+        id_array.append(ids[i]);
+    }
+    id_array.push_back('}');
+    const std::vector<std::string> params = { std::move(id_array) };
+
+    auto result_exp = co_await conn->AsyncExecPrepared(kSelectUsersByIds, params, ResultFormat::Binary);
+    if (!result_exp.has_value()) {
+        co_return std::unexpected(result_exp.error());
+    }
+
+    const auto result_ptr = std::move(result_exp.value());
+    std::vector<User> users;
+    const int rows = result_ptr ? PQntuples(result_ptr.get()) : 0;
+    users.reserve(rows);
+    for (int row = 0; row < rows; ++row) {
+        users.push_back(MapRowToUser(result_ptr.get(), row));
+    }
+    co_return users;
+}
+
 boost::asio::awaitable<std::expected<std::optional<User>, DbError>> UserDao::GetUserByPhoneNumber(const std::string& phone_number) {
     const auto conn = co_await pool_->GetConnection();
-    const std::string sql = "SELECT id, phone_number, username, email, password_hash, salt, avatar_url, status, created_at "
-                  "FROM users WHERE phone_number = $1 AND deleted_at IS NULL LIMIT 1";
     // 避免把临时对象传给协程
     const std::vector<std::string> params = { phone_number };
-    auto result_exp = co_await conn->AsyncExecParams(sql, params);
+    auto result_exp = co_await conn->AsyncExecPrepared(kSelectUserByPhone, params, ResultFormat::Binary);
 
     if (!result_exp.has_value()) {
         co_return std::unexpected(result_exp.error());
@@ -93,39 +143,24 @@ boost::asio::awaitable<std::expected<std::optional<User>, DbError>> UserDao::Get
 
 
 User UserDao::MapRowToUser(const PGresult* res, int row) {
+    // 结果为二进制格式，列顺序与上面各个 SELECT 语句一致
+    const PgRowView view(res, row);
     User user;
 
-    user.id_ = PQgetvalue(res, row, 0);
-    user.phone_number_ = PQgetvalue(res, row, 1);
+    const auto id = view.GetUuid(0);
+    user.id_.assign(id.data(), id.size());
+    user.phone_number_ = view.GetText(1);
 
-    if (!PQgetisnull(res, row, 2)) user.username_ = PQgetvalue(res, row, 2);
-    if (!PQgetisnull(res, row, 3)) user.email_ = PQgetvalue(res, row, 3);
+    if (!view.IsNull(2)) user.username_ = view.GetText(2);
+    if (!view.IsNull(3)) user.email_ = view.GetText(3);
 
-    user.password_hash_ = PQgetvalue(res, row, 4);
-    user.salt_ = PQgetvalue(res, row, 5);
+    user.password_hash_ = view.GetText(4);
+    user.salt_ = view.GetText(5);
 
-    if (!PQgetisnull(res, row, 6)) user.avatar_url_ = PQgetvalue(res, row, 6);
-    user.status_ = static_cast<UserStatus>(std::stoi(PQgetvalue(res, row, 7)));
+    if (!view.IsNull(6)) user.avatar_url_ = view.GetText(6);
+    user.status_ = static_cast<UserStatus>(view.GetInt2(7));
 
-    user.created_at_ = ParsePostgresTimestamp(PQgetvalue(res, row, 8));
+    user.created_at_ = view.GetTimestamptz(8);
 
     return user;
 }
-
-std::chrono::system_clock::time_point UserDao::ParsePostgresTimestamp(const char* timestamp_str) {
-    // 空指针或空字符串检查
-    if (timestamp_str == nullptr || timestamp_str[0] == '\0') {
-        return std::chrono::system_clock::from_time_t(0);
-    }
-
-    std::tm tm = {};
-    // 使用 Linux C 函数解析 "YYYY-MM-DD HH:MM:SS"
-    const char* ptr = strptime(timestamp_str, "%Y-%m-%d %H:%M:%S", &tm);
-    if (ptr == nullptr) {
-        SPDLOG_WARN("Failed to parse timestamp: {}", timestamp_str);
-        return std::chrono::system_clock::from_time_t(0);
-    }
-    // Postgres 存的是需要时 UTC 时间
-    const time_t t = timegm(&tm);
-    return std::chrono::system_clock::from_time_t(t);
-}
\ No newline at end of file
@@ -5,14 +5,14 @@
 #include <optional>
 
 #include "domain/user.h"
-#include "infrastructure/persistence/postgresql/include/async_connection_pool.h"
+#include "infrastructure/persistence/postgresql/interface/i_connection_pool.h"
 
 namespace user_service::infrastructure
 {
     class UserDao
     {
     public:
-        explicit UserDao(const std::shared_ptr<AsyncConnectionPool>& pool);
+        explicit UserDao(const std::shared_ptr<IConnectionPool>& pool);
         ~UserDao();
         // 创建用户
         boost::asio::awaitable<std::expected<void, DbError>> CreateUser(const domain::User& user) const;
@@ -20,14 +20,16 @@ namespace user_service::infrastructure
         // 根据 ID 获取用户
         boost::asio::awaitable<std::expected<std::optional<domain::User>, DbError>> GetUserById(const std::string& id);
 
+        // 根据一组 ID 批量获取用户，不存在的 ID 不会出现在结果中，结果顺序不保证
+        boost::asio::awaitable<std::expected<std::vector<domain::User>, DbError>> GetUsersByIds(const std::vector<std::string>& ids);
+
         // 根据手机号获取用户
         boost::asio::awaitable<std::expected<std::optional<domain::User>, DbError>> GetUserByPhoneNumber(const std::string& phone_number);
 
-    private:
-        domain::User MapRowToUser(const PGresult* res, int row);
-
-        static std::chrono::system_clock::time_point ParsePostgresTimestamp(const char* timestamp_str);
+        // 从二进制格式结果映射，列顺序与各个 SELECT 语句一致 (公开供 benchmark 使用)
+        static domain::User MapRowToUser(const PGresult* res, int row);
 
-        const std::shared_ptr<AsyncConnectionPool> pool_;
+    private:
+        const std::shared_ptr<IConnectionPool> pool_;
     };
 }
\ No newline at end of file
@@ -2,63 +2,74 @@
  // Licensed under the MIT License.
 
  #pragma once
- #include "pq_connection.h"
+ #include "infrastructure/persistence/postgresql/interface/i_connection_pool.h"
  #include <deque>
  #include <memory>
  #include <boost/asio/strand.hpp>
  #include <boost/asio/experimental/channel.hpp>
 
  namespace user_service::infrastructure {
-     // 配置文件
-     struct DbPoolConfig {
-         std::string conn_str;
-         int pool_size;
-     };
-
-     class AsyncConnectionPool;
-     // Deleter 的工作不是 delete 连接，而是将其归还给连接池
-     struct ConnectionReleaser {
-         explicit ConnectionReleaser(const std::shared_ptr<PQConnection> &conn,
-                                     const std::shared_ptr<AsyncConnectionPool> &p) : conn_sh_ptr(conn), pool(p) {}
-         // 实现放后面，因为它需要完整的 Pool 定义，参数需要一定保证是罗指针裸指针
-         void operator()(PQConnection *conn) const;
-         // 持有 PQConnection的shared_ptr 保证不被自动销毁
-         std::shared_ptr<PQConnection> conn_sh_ptr;
-         // 使用 weak_ptr 防止循环引用，并且是线程安全的
-         std::weak_ptr<AsyncConnectionPool> pool;
-     };
+     class AsioThreadPool;
 
-     // 封装池化数据库连接，并添加 deleter
-     using PooledConnection = std::unique_ptr<PQConnection, ConnectionReleaser>;
-
-     class AsyncConnectionPool : public std::enable_shared_from_this<AsyncConnectionPool> {
+     /*
+      * 弹性连接池，所有状态只在 strand 上读写
+      *  - 常驻 pool_size 个连接，有协程排队且未达上限时按需扩容到 max_pool_size
+      *  - 后台维护协程：回收空闲超时的扩容连接、探测长时间空闲的连接 (可关闭)、补足常驻连接
+      *  - 取出的连接若已断开 (例如 RDS 主备切换) 会先透明重连再交给调用方
+      */
+     class AsyncConnectionPool : public IConnectionPool, public std::enable_shared_from_this<AsyncConnectionPool> {
      public:
-         AsyncConnectionPool(const std::shared_ptr<boost::asio::io_context>& ioc, const DbPoolConfig& db_pool_config);
+         AsyncConnectionPool(const std::shared_ptr<AsioThreadPool>& thread_pool, const DbPoolConfig& db_pool_config);
 
-         boost::asio::awaitable<void> Init();
+         boost::asio::awaitable<void> Init() override;
 
          // 核心接口：获取连接
-         boost::asio::awaitable<PooledConnection> GetConnection();
+         boost::asio::awaitable<PooledConnection> GetConnection() override;
 
      private:
-         friend struct ConnectionReleaser;
-         void ReturnConnection(const std::shared_ptr<PQConnection>& conn_sh_ptr);
+         void ReturnConnection(const std::shared_ptr<PQConnection>& conn_sh_ptr) override;
+
+         // 在 strand 上取出一个空闲连接，没有则排队等待
+         boost::asio::awaitable<std::shared_ptr<PQConnection>> AcquireOnStrand();
+
+         // 在 strand 上归还：优先交给等待者，否则放回空闲队列
+         void ReleaseOnStrand(const std::shared_ptr<PQConnection>& conn);
+
+         // 在 strand 上发起一个新连接，建立后通过 ReleaseOnStrand 入池
+         void GrowOnStrand();
+
+         // 后台维护协程 (运行在 strand 上)
+         boost::asio::awaitable<void> RunMaintenance();
 
 
          using WaiterChannel = boost::asio::experimental::channel<void(boost::system::error_code, std::shared_ptr<PQConnection>)>;
 
+         struct IdleConnection {
+             std::shared_ptr<PQConnection> conn;
+             std::chrono::steady_clock::time_point idle_since;
+         };
+
 
-         const std::shared_ptr<boost::asio::io_context> ioc_;
+         const std::shared_ptr<AsioThreadPool> thread_pool_;
          const std::string conn_str_;
-         const int pool_size_;
+         const int min_pool_size_;
+         const int max_pool_size_;
+         const std::chrono::seconds idle_timeout_;
+         const std::chrono::seconds health_check_interval_;
 
          // Strand 串行调度器
          boost::asio::strand<boost::asio::io_context::executor_type> strand_;
 
-         // 空闲连接池
-         std::deque<std::shared_ptr<PQConnection>> pool_;
+         // 空闲连接池，后进先出：队头是空闲最久的连接，方便回收
+         std::deque<IdleConnection> pool_;
+
+         // 连接总数 (空闲 + 借出 + 正在建立)
+         int total_size_ = 0;
+
+         // 新连接轮流分配到各个 io_context
+         size_t next_conn_index_ = 0;
 
          // 维护等待者队列 (利用 Channel 内部公平队列)
          WaiterChannel waiters_channel_;
      };
- }
\ No newline at end of file
+ }
@@ -0,0 +1,70 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#pragma once
+#include "infrastructure/persistence/postgresql/interface/i_connection_pool.h"
+#include "infrastructure/concurrency/mpmc_queue.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/experimental/channel.hpp>
+
+namespace user_service::infrastructure {
+    class AsioThreadPool;
+
+    /*
+     * 分片无锁连接池
+     *  - 快速路径：每个线程对应一个分片 (无锁 MPMC 队列)，获取时先取本分片，空了再从其他分片窃取；
+     *    归还时放回当前线程的分片。全程不经过 strand，也没有线程切换
+     *  - 慢速路径：所有分片都空时，才进入 strand 上的 channel 排队等待；
+     *    归还方发现有等待者时，投递一个任务到 strand，把空闲连接转交给等待者
+     * 连接数固定为 pool_size (分片队列容量在构造时确定)，不参与弹性扩缩容，断开的连接在借出时重连
+     */
+    class LockFreeConnectionPool : public IConnectionPool, public std::enable_shared_from_this<LockFreeConnectionPool> {
+    public:
+        LockFreeConnectionPool(const std::shared_ptr<AsioThreadPool>& thread_pool, const DbPoolConfig& db_pool_config);
+
+        boost::asio::awaitable<void> Init() override;
+
+        boost::asio::awaitable<PooledConnection> GetConnection() override;
+
+    private:
+        void ReturnConnection(const std::shared_ptr<PQConnection>& conn_sh_ptr) override;
+
+        // 当前线程对应的分片
+        [[nodiscard]] size_t CurrentShard() const;
+
+        // 本分片优先，其次按顺序窃取其他分片
+        PQConnection* TryAcquire();
+
+        // 在 strand 上再试一次快速路径，失败则挂起在 channel 上
+        boost::asio::awaitable<PQConnection*> AcquireOnStrand();
+
+        // 在 strand 上把空闲连接转交给等待者
+        void DrainToWaiters();
+
+
+        using WaiterChannel = boost::asio::experimental::channel<void(boost::system::error_code, PQConnection*)>;
+
+
+        const std::shared_ptr<AsioThreadPool> thread_pool_;
+        const std::string conn_str_;
+        const int pool_size_;
+
+        // 连接所有权，Init 之后只读；队列里只放裸指针
+        std::vector<std::shared_ptr<PQConnection>> conns_;
+
+        // 每个线程一个分片，每个分片容量都能放下全部连接，所以 push 不会失败
+        std::vector<std::unique_ptr<MpmcQueue<PQConnection*>>> shards_;
+
+        // 正在走慢速路径的协程数，归还方据此判断是否需要唤醒
+        std::atomic<int> waiting_{0};
+
+        // 慢速路径串行区
+        boost::asio::strand<boost::asio::io_context::executor_type> strand_;
+
+        // 维护等待者队列 (利用 Channel 内部公平队列)
+        WaiterChannel waiters_channel_;
+    };
+}
@@ -0,0 +1,89 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#pragma once
+#include <libpq-fe.h>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace user_service::infrastructure {
+    /*
+     * 二进制结果格式 (resultFormat = 1) 的列解码
+     * 网络字节序 (大端)，格式与 PostgreSQL 的 *_send 函数一致
+     */
+    namespace pg_binary {
+        template<typename T>
+        T LoadBigEndian(const char* data) {
+            T value;
+            std::memcpy(&value, data, sizeof(T));
+            if constexpr (std::endian::native == std::endian::little) {
+                value = std::byteswap(value);
+            }
+            return value;
+        }
+
+        inline int16_t DecodeInt2(const char* data) { return LoadBigEndian<int16_t>(data); }
+        inline int32_t DecodeInt4(const char* data) { return LoadBigEndian<int32_t>(data); }
+        inline int64_t DecodeInt8(const char* data) { return LoadBigEndian<int64_t>(data); }
+
+        // timestamptz：自 2000-01-01 00:00:00 UTC 起的微秒数 (integer_datetimes，PG10 以后唯一格式)，与会话时区无关
+        inline std::chrono::system_clock::time_point DecodeTimestamptz(const char* data) {
+            constexpr std::chrono::seconds kPgEpochOffset{946684800};
+            const std::chrono::microseconds since_pg_epoch{DecodeInt8(data)};
+            return std::chrono::system_clock::time_point(
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(kPgEpochOffset + since_pg_epoch));
+        }
+
+        // uuid：16 个原始字节，格式化为小写 8-4-4-4-12 文本 (与 PostgreSQL 文本输出一致)
+        using UuidText = std::array<char, 36>;
+        inline UuidText DecodeUuid(const char* data) {
+            constexpr char kHex[] = "0123456789abcdef";
+            UuidText out{};
+            size_t pos = 0;
+            for (int i = 0; i < 16; ++i) {
+                if (i == 4 || i == 6 || i == 8 || i == 10) {
+                    out[pos++] = '-';
+                }
+                const auto byte = static_cast<unsigned char>(data[i]);
+                out[pos++] = kHex[byte >> 4];
+                out[pos++] = kHex[byte & 0x0F];
+            }
+            return out;
+        }
+    }
+
+    /*
+     * 结果集中一行的只读视图，不拷贝数据，生命周期不能超过 PGresult
+     * 文本列 (varchar/text) 在两种格式下都是原始字节，可直接取 string_view；
+     * 定长类型的 GetXxx 要求结果为二进制格式
+     */
+    class PgRowView {
+    public:
+        PgRowView(const PGresult* res, const int row) : res_(res), row_(row) {}
+
+        [[nodiscard]] bool IsNull(const int col) const { return PQgetisnull(res_, row_, col) != 0; }
+
+        [[nodiscard]] std::string_view GetText(const int col) const {
+            return {PQgetvalue(res_, row_, col), static_cast<size_t>(PQgetlength(res_, row_, col))};
+        }
+
+        [[nodiscard]] int16_t GetInt2(const int col) const { return pg_binary::DecodeInt2(PQgetvalue(res_, row_, col)); }
+
+        [[nodiscard]] std::chrono::system_clock::time_point GetTimestamptz(const int col) const {
+            return pg_binary::DecodeTimestamptz(PQgetvalue(res_, row_, col));
+        }
+
+        [[nodiscard]] pg_binary::UuidText GetUuid(const int col) const {
+            return pg_binary::DecodeUuid(PQgetvalue(res_, row_, col));
+        }
+
+    private:
+        const PGresult* res_;
+        const int row_;
+    };
+}
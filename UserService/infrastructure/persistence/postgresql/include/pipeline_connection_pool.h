@@ -0,0 +1,36 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#pragma once
+#include "infrastructure/persistence/postgresql/interface/i_connection_pool.h"
+#include <memory>
+#include <vector>
+
+namespace user_service::infrastructure {
+    class AsioThreadPool;
+
+    /*
+     * 多路复用连接池：连接工作在 libpq pipeline 模式下，不再独占
+     * GetConnection 直接返回在途查询最少的连接，多个协程的查询在同一条连接上排队发送，结果按序分发，
+     * 少量连接即可掩盖网络往返延迟。归还是空操作
+     * 注意：共享连接上不能使用事务等依赖会话状态的语句
+     */
+    class PipelineConnectionPool : public IConnectionPool, public std::enable_shared_from_this<PipelineConnectionPool> {
+    public:
+        PipelineConnectionPool(const std::shared_ptr<AsioThreadPool>& thread_pool, const DbPoolConfig& db_pool_config);
+
+        boost::asio::awaitable<void> Init() override;
+
+        boost::asio::awaitable<PooledConnection> GetConnection() override;
+
+    private:
+        void ReturnConnection(const std::shared_ptr<PQConnection>& conn_sh_ptr) override;
+
+        const std::shared_ptr<AsioThreadPool> thread_pool_;
+        const std::string conn_str_;
+        const int pool_size_;
+
+        // Init 之后只读
+        std::vector<std::shared_ptr<PQConnection>> conns_;
+    };
+}
@@ -5,27 +5,77 @@
 #include "infrastructure/persistence/postgresql/include/db_error.h"
 #include <libpq-fe.h>
 #include <boost/asio.hpp>
+#include <boost/asio/experimental/channel.hpp>
+#include <atomic>
+#include <deque>
 #include <string>
 #include <vector>
 #include <memory>
+#include <optional>
 #include <expected>
+#include <string_view>
+#include <unordered_set>
 
 namespace user_service::infrastructure {
 
     using PGResultPtr = std::unique_ptr<PGresult, decltype(&PQclear)>;
 
+    // 结果格式：二进制格式省去服务端格式化和客户端解析，配合 PgRowView 使用
+    enum class ResultFormat : int {
+        Text = 0,
+        Binary = 1
+    };
+
+    // 服务端预编译语句：name 是语句 id，在一个连接内唯一；两者都应指向静态字符串
+    struct PreparedStatement {
+        const char* name;
+        const char* sql;
+    };
+
     class PQConnection : public std::enable_shared_from_this<PQConnection> {
     public:
         explicit PQConnection(boost::asio::io_context &ioc);
+        ~PQConnection();
 
         boost::asio::awaitable<void> AsyncConnect(const std::string &conn_str);
 
+        /*
+         * 开启 pipeline 模式 (需在 AsyncConnect 之前调用)：
+         * 连接进入 libpq pipeline 模式，AsyncExecParams 改走流水线路径，可以被多个协程同时共享，
+         * 查询依次写入发送缓冲，不必等待上一个结果返回；结果按发送顺序分发给各自的协程
+         */
+        void EnablePipeline() { pipeline_enabled_ = true; }
+
+        [[nodiscard]] bool IsPipelined() const { return pipeline_enabled_; }
+
+        // 流水线中已发送、尚未拿到结果的查询数
+        [[nodiscard]] size_t InFlight() const { return in_flight_.load(std::memory_order_relaxed); }
+
+        // 连接可用：已连上且没有未读完的结果（查询中途抛异常的连接会一直 busy）
+        [[nodiscard]] bool IsHealthy() const;
+
+        // 断开并用上次的连接串重新连接，失败抛出异常
+        boost::asio::awaitable<void> Reconnect();
+
+        // 不健康时透明重连
+        boost::asio::awaitable<void> EnsureConnected();
+
+        // 存活探测，执行 SELECT 1，任何失败都返回 false
+        boost::asio::awaitable<bool> Ping();
+
         boost::asio::awaitable<std::expected<PGResultPtr, DbError>> AsyncExecParams(const std::string &query,
                                                               const std::vector<std::string> &params);
 
+        // 执行预编译语句：本连接首次使用时先 PQsendPrepare，之后只发 PQsendQueryPrepared，省去服务端解析和规划
+        boost::asio::awaitable<std::expected<PGResultPtr, DbError>> AsyncExecPrepared(const PreparedStatement &stmt,
+                                                                const std::vector<std::string> &params,
+                                                                ResultFormat result_format = ResultFormat::Text);
+
     private:
         // 1. 发送查询指令
-        void SendQuery(const std::string &query, const std::vector<std::string> &params);
+        void SendQuery(const char *query, const std::vector<std::string> &params);
+        void SendPrepare(const PreparedStatement &stmt, size_t param_count);
+        void SendQueryPrepared(const char *stmt_name, const std::vector<std::string> &params, ResultFormat result_format);
 
         // 2. 协程等待数据库响应
         boost::asio::awaitable<void> AwaitResponse();
@@ -36,9 +86,59 @@ namespace user_service::infrastructure {
         // 4. 将底层结果转换为业务预期的 expected 对象
         std::expected<PGResultPtr, DbError> MapResultToExpected(PGResultPtr result);
 
+        /* pipeline 模式：以下函数和状态只在 strand_ 上访问 */
+        struct PipelineRequest {
+            explicit PipelineRequest(const boost::asio::strand<boost::asio::io_context::executor_type>& strand) : done(strand, 1) {}
+            std::optional<std::expected<PGResultPtr, DbError>> result;
+            // 本请求捎带了 PQsendPrepare 时，其结果排在查询结果前面，需要跳过
+            const char* prepare_name = nullptr;
+            // 结果就绪信号，容量为 1，分发方 try_send 不会失败
+            boost::asio::experimental::channel<void(boost::system::error_code)> done;
+        };
+
+        // 发送查询和同步点，挂起直到自己的结果到达 (结果放在 request 里返回，PGResultPtr 不可默认构造，不能直接作为 co_spawn 的返回值)
+        // stmt 非空时执行预编译语句，否则执行 query
+        boost::asio::awaitable<std::shared_ptr<PipelineRequest>> ExecPipelinedOnStrand(const char *query,
+                                                                                       const PreparedStatement *stmt,
+                                                                                       const std::vector<std::string> &params,
+                                                                                       ResultFormat result_format);
+
+        // 发送缓冲未能一次写完时，等待可写后继续
+        boost::asio::awaitable<void> FlushPipeline();
+
+        // 读协程：有未完成的查询时持续读取并分发结果
+        boost::asio::awaitable<void> ReadPipelineResults();
+
+        // 取出所有已完整到达的结果，按顺序交给队头请求
+        void DispatchPipelineResults();
+
+        // 连接出错：让所有未完成的请求失败，并标记连接需要重连
+        void FailPipeline(const std::string &reason);
+
+        // 重连时使用
+        std::string conn_str_;
         // 维护数据库连接，
         std::unique_ptr<PGconn, decltype(&PQfinish)> conn_;
+
+        // 本会话已预编译的语句名，预编译语句随会话消失，重连时清空
+        struct StringHash {
+            using is_transparent = void;
+            size_t operator()(const std::string_view sv) const { return std::hash<std::string_view>{}(sv); }
+        };
+        std::unordered_set<std::string, StringHash, std::equal_to<>> prepared_statements_;
         // boost提供的描述符管理器
         boost::asio::posix::stream_descriptor socket_;
+
+        bool pipeline_enabled_ = false;
+        // 流水线的串行区，发送、读取、分发都在这里
+        boost::asio::strand<boost::asio::io_context::executor_type> strand_;
+        // 已发送未完成的请求，顺序与发送顺序一致
+        std::deque<std::shared_ptr<PipelineRequest>> pipeline_queue_;
+        bool flushing_ = false;
+        bool reading_ = false;
+        bool reconnecting_ = false;
+        // 流水线出错后结果序列已不可信，必须重连
+        bool pipeline_broken_ = false;
+        std::atomic<size_t> in_flight_{0};
     };
 }
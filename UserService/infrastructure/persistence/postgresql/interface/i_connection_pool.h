@@ -0,0 +1,66 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#pragma once
+#include "infrastructure/persistence/postgresql/include/pq_connection.h"
+#include <chrono>
+#include <memory>
+#include <spdlog/spdlog.h>
+
+namespace user_service::infrastructure {
+    // 连接池实现
+    enum class DbPoolImpl {
+        Strand,     // strand + channel，所有获取/归还在 strand 上串行
+        LockFree,   // 分片无锁队列快速路径，channel 等待队列仅作为慢速路径
+        Pipeline    // libpq pipeline 模式，连接被多个协程共享
+    };
+
+    // 配置文件
+    struct DbPoolConfig {
+        std::string conn_str;
+        int pool_size;                                  // 常驻连接数 (最小连接数)
+        DbPoolImpl impl;
+        int max_pool_size;                              // 突发时最多扩容到的连接数，不大于 pool_size 时不扩容
+        std::chrono::seconds idle_timeout;              // 超出 pool_size 的连接空闲这么久后回收
+        std::chrono::seconds health_check_interval;     // 后台存活探测周期，0 代表关闭 (不影响回收)
+    };
+
+    class IConnectionPool;
+    // Deleter 的工作不是 delete 连接，而是将其归还给连接池
+    struct ConnectionReleaser {
+        explicit ConnectionReleaser(const std::shared_ptr<PQConnection> &conn,
+                                    const std::shared_ptr<IConnectionPool> &p) : conn_sh_ptr(conn), pool(p) {}
+        // 实现放后面，因为它需要完整的 Pool 定义，参数需要一定保证是罗指针裸指针
+        void operator()(PQConnection *conn) const;
+        // 持有 PQConnection的shared_ptr 保证不被自动销毁
+        std::shared_ptr<PQConnection> conn_sh_ptr;
+        // 使用 weak_ptr 防止循环引用，并且是线程安全的
+        std::weak_ptr<IConnectionPool> pool;
+    };
+
+    // 封装池化数据库连接，并添加 deleter
+    using PooledConnection = std::unique_ptr<PQConnection, ConnectionReleaser>;
+
+    // 提供连接池统一接口，UserDao 只依赖该接口
+    class IConnectionPool {
+    public:
+        virtual ~IConnectionPool() = default;
+
+        virtual boost::asio::awaitable<void> Init() = 0;
+
+        // 核心接口：获取连接
+        virtual boost::asio::awaitable<PooledConnection> GetConnection() = 0;
+
+    protected:
+        friend struct ConnectionReleaser;
+        virtual void ReturnConnection(const std::shared_ptr<PQConnection>& conn_sh_ptr) = 0;
+    };
+
+    inline void ConnectionReleaser::operator()(PQConnection *) const {
+        if (const auto pool_sh_ptr = pool.lock()) {
+            pool_sh_ptr->ReturnConnection(conn_sh_ptr);
+        } else {
+            spdlog::warn("Connection pool gone. Connection will be closed.");
+        }
+    }
+}
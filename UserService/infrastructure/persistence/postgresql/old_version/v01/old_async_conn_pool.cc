@@ -4,7 +4,7 @@
 #include "infrastructure/persistence/postgresql/old_version/v01/old_async_conn_pool.h"
 #include <spdlog/spdlog.h>
 
-using namespace user_service::infrastructure;
+using namespace user_service::infrastructure::old_v01;
 
 
 AsyncConnectionPool::AsyncConnectionPool(const std::shared_ptr<boost::asio::io_context>& ioc, const DbPoolConfig& db_pool_config)
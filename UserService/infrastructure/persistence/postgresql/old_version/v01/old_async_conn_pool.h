@@ -9,7 +9,8 @@
 #include <boost/asio/experimental/channel.hpp>
 
 
-namespace user_service::infrastructure {
+// 历史版本放在独立的命名空间，可与当前版本同时链接 (用于 benchmark 对比)
+namespace user_service::infrastructure::old_v01 {
     // 配置文件
     struct DbPoolConfig {
         std::string conn_str;
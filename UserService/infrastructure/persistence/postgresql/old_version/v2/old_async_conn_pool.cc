@@ -4,7 +4,7 @@
 #include "infrastructure/persistence/postgresql/old_version/v2/old_async_conn_pool.h"
 #include <spdlog/spdlog.h>
 
-using namespace user_service::infrastructure;
+using namespace user_service::infrastructure::old_v2;
 
 // ==========================================
 // 协程核心：自定义 Awaiter 实现
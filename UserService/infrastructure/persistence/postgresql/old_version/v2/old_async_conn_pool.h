@@ -8,7 +8,7 @@
 #include <coroutine>
 #include <boost/asio/strand.hpp>
 
-namespace user_service::infrastructure {
+namespace user_service::infrastructure::old_v2 {
     // 配置文件
     struct DbPoolConfig {
         std::string conn_str;
@@ -2,69 +2,162 @@
 // Licensed under the MIT License.
 
 #include "../include/async_connection_pool.h"
+#include "infrastructure/asio_thread_pool/asio_thread_pool.h"
+#include <algorithm>
 
 using namespace user_service::infrastructure;
 
 
-AsyncConnectionPool::AsyncConnectionPool(const std::shared_ptr<boost::asio::io_context>& ioc, const DbPoolConfig& db_pool_config)
-    : ioc_(ioc),
+AsyncConnectionPool::AsyncConnectionPool(const std::shared_ptr<AsioThreadPool>& thread_pool, const DbPoolConfig& db_pool_config)
+    : thread_pool_(thread_pool),
       conn_str_(db_pool_config.conn_str),
-      pool_size_(db_pool_config.pool_size),
-      strand_(boost::asio::make_strand(*ioc)),
+      min_pool_size_(db_pool_config.pool_size),
+      max_pool_size_(std::max(db_pool_config.max_pool_size, db_pool_config.pool_size)),
+      idle_timeout_(db_pool_config.idle_timeout),
+      health_check_interval_(db_pool_config.health_check_interval),
+      strand_(boost::asio::make_strand(*thread_pool->GetIOContext(0))),
       waiters_channel_(strand_, 0)
 {
-    if (pool_size_ <= 0) throw std::invalid_argument("Pool size must be positive.");
+    if (min_pool_size_ <= 0) throw std::invalid_argument("Pool size must be positive.");
 }
 
 boost::asio::awaitable<void> AsyncConnectionPool::Init() {
-    SPDLOG_DEBUG("Initializing connection pool with size {}...", pool_size_);
-    // Init 是串行调用的，不需要锁保护
-    for (int i = 0; i < pool_size_; ++i) {
-        auto conn = std::make_shared<PQConnection>(*ioc_);
+    SPDLOG_DEBUG("Initializing connection pool with size {}-{}...", min_pool_size_, max_pool_size_);
+    // 常驻连接同步建立，失败直接抛出，阻止服务启动
+    std::vector<std::shared_ptr<PQConnection>> conns;
+    for (int i = 0; i < min_pool_size_; ++i) {
+        // 连接的 socket 轮流注册到各个 io_context 上 (per-core 模式下分摊到各核心)
+        auto conn = std::make_shared<PQConnection>(*thread_pool_->GetIOContext(i));
         co_await conn->AsyncConnect(conn_str_);
-        pool_.push_back(conn);
+        conns.push_back(std::move(conn));
     }
+    // 入池和启动维护协程都在 strand 上完成
+    co_await boost::asio::co_spawn(strand_, [this, conns = std::move(conns)]() -> boost::asio::awaitable<void> {
+        for (const auto& conn : conns) {
+            pool_.push_back({conn, std::chrono::steady_clock::now()});
+        }
+        total_size_ = static_cast<int>(conns.size());
+        next_conn_index_ = conns.size();
+        // 可扩容 (需要回收、补足) 或开启了存活探测时才需要维护协程
+        if (max_pool_size_ > min_pool_size_ || health_check_interval_.count() > 0) {
+            boost::asio::co_spawn(strand_, RunMaintenance(), boost::asio::detached);
+        }
+        co_return;
+    }, boost::asio::use_awaitable);
     SPDLOG_DEBUG("Connection pool initialized successfully.");
 }
 
 boost::asio::awaitable<PooledConnection> AsyncConnectionPool::GetConnection() {
-
-    // post 到串行区执行
-    co_await boost::asio::post(strand_, boost::asio::use_awaitable);
-
     std::shared_ptr<PQConnection> conn;
 
-    if (!pool_.empty()) {
-        conn = pool_.front();
-        pool_.pop_front();
+    if (thread_pool_->GetModel() == ExecutorModel::Shared) {
+        // 调用方与 strand 同属一个 io_context，post 完成后协程会在 strand 内被就地恢复，后续代码直接处于串行区
+        co_await boost::asio::post(strand_, boost::asio::use_awaitable);
+        conn = co_await AcquireOnStrand();
     } else {
-        // 把当前协程挂起并放入 Channel 的内部队列
-        conn = co_await waiters_channel_.async_receive(boost::asio::use_awaitable);
+        /* per-core 模式下调用方运行在其他 io_context 上，post 完成后协程会被投递回自己的 io_context，
+         * 已经不在 strand 内了，所以必须让取连接的逻辑作为子协程整体跑在 strand 上 */
+        conn = co_await boost::asio::co_spawn(strand_, AcquireOnStrand(), boost::asio::use_awaitable);
     }
 
     // 无论是从池子拿的，还是别人用完了的，conn 都有值了
-    co_return PooledConnection(conn.get(), ConnectionReleaser(conn, shared_from_this()));
+    PooledConnection pooled(conn.get(), ConnectionReleaser(conn, shared_from_this()));
+    // 已断开的连接先重连；重连失败时异常抛给调用方，pooled 析构会把连接还回池子，下次获取或后台维护时再重试
+    co_await pooled->EnsureConnected();
+    co_return pooled;
+}
+
+boost::asio::awaitable<std::shared_ptr<PQConnection>> AsyncConnectionPool::AcquireOnStrand() {
+    if (!pool_.empty()) {
+        auto conn = std::move(pool_.back().conn);
+        pool_.pop_back();
+        co_return conn;
+    }
+    // 没有空闲连接，未达上限则扩容，新连接建立后会直接交给排在最前面的等待者
+    if (total_size_ < max_pool_size_) {
+        GrowOnStrand();
+    }
+    // 把当前协程挂起并放入 Channel 的内部队列
+    co_return co_await waiters_channel_.async_receive(boost::asio::use_awaitable);
 }
 
 void AsyncConnectionPool::ReturnConnection(const std::shared_ptr<PQConnection>& conn_sh_ptr) {
     // 任务提交到 strand 串行区执行
-    boost::asio::post(strand_, [this, conn = conn_sh_ptr]() mutable {
-        // 尝试直接发送给等待者
-        // try_send 检查 Channel 内部队列是否有挂起的协程
-        // 如果有，返回 true 并直接把 conn 塞给他唤醒；如果没有，返回 false
-        const bool given_to_waiter = waiters_channel_.try_send(boost::system::error_code{}, conn);
-
-        if (!given_to_waiter) {
-            // 没有挂起等待的协程了，放回池子
-            pool_.push_back(conn);
-        }
+    boost::asio::post(strand_, [this, conn = conn_sh_ptr]() {
+        ReleaseOnStrand(conn);
     });
 }
 
-void ConnectionReleaser::operator()(PQConnection *conn) const {
-    if (const auto pool_sh_ptr = pool.lock()) {
-        pool_sh_ptr->ReturnConnection(conn_sh_ptr);
-    } else {
-        spdlog::warn("Connection pool gone. Connection will be closed.");
+void AsyncConnectionPool::ReleaseOnStrand(const std::shared_ptr<PQConnection>& conn) {
+    // 尝试直接发送给等待者
+    // try_send 检查 Channel 内部队列是否有挂起的协程
+    // 如果有，返回 true 并直接把 conn 塞给他唤醒；如果没有，返回 false
+    const bool given_to_waiter = waiters_channel_.try_send(boost::system::error_code{}, conn);
+
+    if (!given_to_waiter) {
+        // 没有挂起等待的协程了，放回池子
+        pool_.push_back({conn, std::chrono::steady_clock::now()});
     }
-}
\ No newline at end of file
+}
+
+void AsyncConnectionPool::GrowOnStrand() {
+    // 先占名额，避免并发的等待者重复扩容超过上限
+    ++total_size_;
+    const auto& ioc = thread_pool_->GetIOContext(next_conn_index_++);
+    SPDLOG_DEBUG("Growing connection pool to {}", total_size_);
+    boost::asio::co_spawn(strand_, [self = shared_from_this(), conn = std::make_shared<PQConnection>(*ioc)]()
+        -> boost::asio::awaitable<void> {
+        try {
+            co_await conn->AsyncConnect(self->conn_str_);
+        } catch (const std::exception& e) {
+            // 回到 strand 上才能改计数 (协程执行器就是 strand)
+            --self->total_size_;
+            SPDLOG_WARN("Failed to grow connection pool: {}", e.what());
+            co_return;
+        }
+        self->ReleaseOnStrand(conn);
+    }, boost::asio::detached);
+}
+
+boost::asio::awaitable<void> AsyncConnectionPool::RunMaintenance() {
+    // 持有自身，保证协程挂起期间连接池不被析构
+    const auto self = shared_from_this();
+    const bool health_check_enabled = health_check_interval_.count() > 0;
+    // 周期取回收超时与探测周期中较小者，回收不会被探测周期拖慢 (idle_timeout 配置校验保证为正)
+    const auto period = health_check_enabled ? std::min(idle_timeout_, health_check_interval_) : idle_timeout_;
+    boost::asio::steady_timer timer(strand_);
+    while (true) {
+        timer.expires_after(period);
+        co_await timer.async_wait(boost::asio::use_awaitable);
+        const auto now = std::chrono::steady_clock::now();
+
+        // 1. 回收：队头空闲最久，只回收超出常驻数量的部分
+        while (total_size_ > min_pool_size_ && !pool_.empty() && now - pool_.front().idle_since >= idle_timeout_) {
+            pool_.pop_front();
+            --total_size_;
+        }
+
+        // 2. 探测 (关闭时跳过)：空闲超过一整个探测周期的连接才需要 ping，先取出来避免探测期间被借走
+        std::vector<std::shared_ptr<PQConnection>> to_check;
+        while (health_check_enabled && !pool_.empty() && now - pool_.front().idle_since >= health_check_interval_) {
+            to_check.push_back(std::move(pool_.front().conn));
+            pool_.pop_front();
+        }
+        for (const auto& conn : to_check) {
+            if (!co_await conn->Ping()) {
+                try {
+                    co_await conn->Reconnect();
+                } catch (const std::exception& e) {
+                    // 仍然放回池子，下次被借出或下个周期再重连
+                    SPDLOG_WARN("Reconnect in health check failed: {}", e.what());
+                }
+            }
+            ReleaseOnStrand(conn);
+        }
+
+        // 3. 补足常驻连接 (扩容失败等情况可能导致不足)
+        while (total_size_ < min_pool_size_) {
+            GrowOnStrand();
+        }
+    }
+}
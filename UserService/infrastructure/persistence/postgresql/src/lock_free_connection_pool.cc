@@ -0,0 +1,103 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#include "../include/lock_free_connection_pool.h"
+#include "infrastructure/asio_thread_pool/asio_thread_pool.h"
+#include <algorithm>
+
+using namespace user_service::infrastructure;
+
+
+LockFreeConnectionPool::LockFreeConnectionPool(const std::shared_ptr<AsioThreadPool>& thread_pool, const DbPoolConfig& db_pool_config)
+    : thread_pool_(thread_pool),
+      conn_str_(db_pool_config.conn_str),
+      pool_size_(db_pool_config.pool_size),
+      strand_(boost::asio::make_strand(*thread_pool->GetIOContext(0))),
+      waiters_channel_(strand_, 0)
+{
+    if (pool_size_ <= 0) throw std::invalid_argument("Pool size must be positive.");
+    const size_t shard_count = std::max<size_t>(thread_pool_->ThreadCount(), 1);
+    shards_.reserve(shard_count);
+    for (size_t i = 0; i < shard_count; ++i) {
+        shards_.push_back(std::make_unique<MpmcQueue<PQConnection*>>(pool_size_));
+    }
+}
+
+boost::asio::awaitable<void> LockFreeConnectionPool::Init() {
+    SPDLOG_DEBUG("Initializing lock-free connection pool with size {}, shards {}...", pool_size_, shards_.size());
+    conns_.reserve(pool_size_);
+    for (int i = 0; i < pool_size_; ++i) {
+        auto conn = std::make_shared<PQConnection>(*thread_pool_->GetIOContext(i));
+        co_await conn->AsyncConnect(conn_str_);
+        conns_.push_back(conn);
+        // 初始连接轮流分配到各分片
+        shards_[i % shards_.size()]->TryPush(conn.get());
+    }
+    SPDLOG_DEBUG("Lock-free connection pool initialized successfully.");
+}
+
+size_t LockFreeConnectionPool::CurrentShard() const {
+    // per-core 模式下线程与 io_context 一一对应，直接用其下标
+    if (const auto index = AsioThreadPool::CurrentIndex(); index && thread_pool_->GetModel() == ExecutorModel::PerCore) {
+        return *index % shards_.size();
+    }
+    // shared 模式下所有线程都跑同一个 io_context，给每个线程轮流分配一个分片
+    static std::atomic<size_t> next_shard{0};
+    thread_local const size_t tls_shard = next_shard.fetch_add(1, std::memory_order_relaxed);
+    return tls_shard % shards_.size();
+}
+
+PQConnection* LockFreeConnectionPool::TryAcquire() {
+    const size_t home = CurrentShard();
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        if (auto conn = shards_[(home + i) % shards_.size()]->TryPop()) {
+            return *conn;
+        }
+    }
+    return nullptr;
+}
+
+boost::asio::awaitable<PooledConnection> LockFreeConnectionPool::GetConnection() {
+    PQConnection* conn = TryAcquire();
+    if (!conn) {
+        /* 慢速路径：先登记为等待者再去 strand 上重试
+         * 与 ReturnConnection 构成 Dekker 式的配对 (两边各一个 seq_cst fence)：
+         * 要么归还方看到 waiting_ > 0 并投递 DrainToWaiters，要么这里的重试能看到归还的连接，不会丢失唤醒 */
+        waiting_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        conn = co_await boost::asio::co_spawn(strand_, AcquireOnStrand(), boost::asio::use_awaitable);
+        waiting_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    auto conn_sh_ptr = conn->shared_from_this();
+    PooledConnection pooled(conn, ConnectionReleaser(conn_sh_ptr, shared_from_this()));
+    // 已断开的连接先透明重连，失败时异常抛给调用方，pooled 析构归还连接
+    co_await pooled->EnsureConnected();
+    co_return pooled;
+}
+
+boost::asio::awaitable<PQConnection*> LockFreeConnectionPool::AcquireOnStrand() {
+    if (auto* conn = TryAcquire()) {
+        co_return conn;
+    }
+    co_return co_await waiters_channel_.async_receive(boost::asio::use_awaitable);
+}
+
+void LockFreeConnectionPool::ReturnConnection(const std::shared_ptr<PQConnection>& conn_sh_ptr) {
+    // 容量足够放下所有连接，不会失败
+    shards_[CurrentShard()]->TryPush(conn_sh_ptr.get());
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting_.load(std::memory_order_relaxed) > 0) {
+        boost::asio::post(strand_, [self = shared_from_this()] { self->DrainToWaiters(); });
+    }
+}
+
+void LockFreeConnectionPool::DrainToWaiters() {
+    while (auto* conn = TryAcquire()) {
+        // try_send 只在有挂起的等待者时成功
+        if (!waiters_channel_.try_send(boost::system::error_code{}, conn)) {
+            // 没有等待者了 (已在 AcquireOnStrand 中拿到连接)，放回去
+            shards_[CurrentShard()]->TryPush(conn);
+            return;
+        }
+    }
+}
@@ -0,0 +1,44 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#include "../include/pipeline_connection_pool.h"
+#include "infrastructure/asio_thread_pool/asio_thread_pool.h"
+
+using namespace user_service::infrastructure;
+
+
+PipelineConnectionPool::PipelineConnectionPool(const std::shared_ptr<AsioThreadPool>& thread_pool, const DbPoolConfig& db_pool_config)
+    : thread_pool_(thread_pool),
+      conn_str_(db_pool_config.conn_str),
+      pool_size_(db_pool_config.pool_size)
+{
+    if (pool_size_ <= 0) throw std::invalid_argument("Pool size must be positive.");
+}
+
+boost::asio::awaitable<void> PipelineConnectionPool::Init() {
+    SPDLOG_DEBUG("Initializing pipeline connection pool with size {}...", pool_size_);
+    conns_.reserve(pool_size_);
+    for (int i = 0; i < pool_size_; ++i) {
+        auto conn = std::make_shared<PQConnection>(*thread_pool_->GetIOContext(i));
+        conn->EnablePipeline();
+        co_await conn->AsyncConnect(conn_str_);
+        conns_.push_back(std::move(conn));
+    }
+    SPDLOG_DEBUG("Pipeline connection pool initialized successfully.");
+}
+
+boost::asio::awaitable<PooledConnection> PipelineConnectionPool::GetConnection() {
+    // 连接数很少，线性扫描即可；InFlight 是原子计数，读到的略旧也无妨
+    const std::shared_ptr<PQConnection>* best = &conns_.front();
+    for (const auto& conn : conns_) {
+        if (conn->InFlight() < (*best)->InFlight()) {
+            best = &conn;
+        }
+    }
+    // 断线重连由连接自身在 strand 上完成
+    co_return PooledConnection(best->get(), ConnectionReleaser(*best, shared_from_this()));
+}
+
+void PipelineConnectionPool::ReturnConnection(const std::shared_ptr<PQConnection>&) {
+    // 连接是共享的，没有归还动作
+}
@@ -6,10 +6,20 @@
 
 using namespace user_service::infrastructure;
 
-PQConnection::PQConnection(boost::asio::io_context &ioc) : conn_(nullptr, &PQfinish), socket_(ioc) {
+PQConnection::PQConnection(boost::asio::io_context &ioc) : conn_(nullptr, &PQfinish), socket_(ioc),
+    strand_(boost::asio::make_strand(ioc)) {
+}
+
+PQConnection::~PQConnection() {
+    // 描述符归 libpq 所有，由 PQfinish 关闭，这里只解除 asio 的托管，避免重复 close
+    if (socket_.is_open()) {
+        socket_.release();
+    }
 }
 
 boost::asio::awaitable<void> PQConnection::AsyncConnect(const std::string &conn_str) {
+    conn_str_ = conn_str;
+    prepared_statements_.clear();
     // 异步启动连接
     conn_.reset(PQconnectStart(conn_str.c_str()));
     if (!conn_ || PQstatus(conn_.get()) == CONNECTION_BAD) {
@@ -29,6 +39,13 @@ boost::asio::awaitable<void> PQConnection::AsyncConnect(const std::string &conn_
             co_await socket_.async_wait(boost::asio::posix::stream_descriptor::wait_read, boost::asio::use_awaitable);
         } else if (poll_status == PGRES_POLLING_OK) {
             SPDLOG_DEBUG("Connected to Postgresql successfully!");
+            if (pipeline_enabled_) {
+                // pipeline 模式要求非阻塞连接，否则 PQflush/PQsendQuery 可能阻塞线程
+                if (PQsetnonblocking(conn_.get(), 1) != 0 || PQenterPipelineMode(conn_.get()) == 0) {
+                    throw std::runtime_error(std::string("Failed to enter pipeline mode: ") + PQerrorMessage(conn_.get()));
+                }
+                pipeline_broken_ = false;
+            }
             co_return; // 连接成功
         } else {
             throw std::runtime_error(std::string("Async connection failed: ") + PQerrorMessage(conn_.get()));
@@ -36,10 +53,54 @@ boost::asio::awaitable<void> PQConnection::AsyncConnect(const std::string &conn_
     }
 }
 
+bool PQConnection::IsHealthy() const {
+    if (!conn_ || PQstatus(conn_.get()) != CONNECTION_OK) {
+        return false;
+    }
+    // pipeline 模式下有在途查询是常态
+    return pipeline_enabled_ ? !pipeline_broken_ : PQisBusy(conn_.get()) == 0;
+}
+
+boost::asio::awaitable<void> PQConnection::Reconnect() {
+    SPDLOG_WARN("PostgreSQL connection broken, reconnecting...");
+    // 先解除 asio 托管再 PQfinish，重连后 PQsocket 会是新的描述符
+    if (socket_.is_open()) {
+        socket_.release();
+    }
+    conn_.reset();
+    co_await AsyncConnect(conn_str_);
+    SPDLOG_INFO("PostgreSQL connection re-established.");
+}
+
+boost::asio::awaitable<void> PQConnection::EnsureConnected() {
+    if (!IsHealthy()) {
+        co_await Reconnect();
+    }
+}
+
+boost::asio::awaitable<bool> PQConnection::Ping() {
+    if (!IsHealthy()) {
+        co_return false;
+    }
+    try {
+        const auto result = co_await AsyncExecParams("SELECT 1", {});
+        co_return result.has_value();
+    } catch (const std::exception& e) {
+        SPDLOG_WARN("PostgreSQL ping failed: {}", e.what());
+        co_return false;
+    }
+}
+
 boost::asio::awaitable<std::expected<PGResultPtr, DbError>> PQConnection::AsyncExecParams(const std::string &query,
                                                                     const std::vector<std::string> &params) {
+    if (pipeline_enabled_) {
+        // 调用方可能在任意执行器上，整个流水线逻辑作为子协程跑在连接自己的 strand 上
+        const auto request = co_await boost::asio::co_spawn(strand_, ExecPipelinedOnStrand(query.c_str(), nullptr, params, ResultFormat::Text),
+                                                             boost::asio::use_awaitable);
+        co_return std::move(*request->result);
+    }
     // 1. 发送
-    SendQuery(query, params);
+    SendQuery(query.c_str(), params);
     // 2. 等待
     co_await AwaitResponse();
     // 3. 取值
@@ -48,24 +109,71 @@ boost::asio::awaitable<std::expected<PGResultPtr, DbError>> PQConnection::AsyncE
     co_return MapResultToExpected(std::move(raw_result));
 }
 
+boost::asio::awaitable<std::expected<PGResultPtr, DbError>> PQConnection::AsyncExecPrepared(const PreparedStatement &stmt,
+                                                                      const std::vector<std::string> &params,
+                                                                      const ResultFormat result_format) {
+    if (pipeline_enabled_) {
+        const auto request = co_await boost::asio::co_spawn(strand_, ExecPipelinedOnStrand(nullptr, &stmt, params, result_format),
+                                                             boost::asio::use_awaitable);
+        co_return std::move(*request->result);
+    }
+    // 独占连接上不能连发两条命令，首次使用多一次往返
+    if (!prepared_statements_.contains(std::string_view(stmt.name))) {
+        SendPrepare(stmt, params.size());
+        co_await AwaitResponse();
+        auto prepare_result = MapResultToExpected(FetchRawResult());
+        if (!prepare_result.has_value()) {
+            co_return std::unexpected(prepare_result.error());
+        }
+        prepared_statements_.emplace(stmt.name);
+    }
+    SendQueryPrepared(stmt.name, params, result_format);
+    co_await AwaitResponse();
+    co_return MapResultToExpected(FetchRawResult());
+}
+
 /* AsyncExecParams 子函数 */
 
-void PQConnection::SendQuery(const std::string &query, const std::vector<std::string> &params) {
+namespace {
     // 维护参数列表
-    std::vector<const char *> param_values;
-    param_values.reserve(params.size());
-    for (const auto &p: params) {
-        param_values.push_back(p.c_str());
+    std::vector<const char *> ToParamValues(const std::vector<std::string> &params) {
+        std::vector<const char *> param_values;
+        param_values.reserve(params.size());
+        for (const auto &p: params) {
+            param_values.push_back(p.c_str());
+        }
+        return param_values;
     }
+}
+
+void PQConnection::SendQuery(const char *query, const std::vector<std::string> &params) {
+    const auto param_values = ToParamValues(params);
 
     // 非阻塞查询 （严重错误）
-    if (PQsendQueryParams(conn_.get(), query.c_str(), params.size(), nullptr,
+    if (PQsendQueryParams(conn_.get(), query, params.size(), nullptr,
                           param_values.data(), nullptr, nullptr, 0) == 0) {
         // 严重错误（网络/OOM等）,当下阶段选择抛出异常
         throw std::runtime_error(std::string("Failed to send query: ") + PQerrorMessage(conn_.get()));
     }
 }
 
+void PQConnection::SendPrepare(const PreparedStatement &stmt, const size_t param_count) {
+    // 参数类型交给服务端推断
+    if (PQsendPrepare(conn_.get(), stmt.name, stmt.sql, static_cast<int>(param_count), nullptr) == 0) {
+        throw std::runtime_error(std::string("Failed to send prepare: ") + PQerrorMessage(conn_.get()));
+    }
+}
+
+void PQConnection::SendQueryPrepared(const char *stmt_name, const std::vector<std::string> &params,
+                                     const ResultFormat result_format) {
+    const auto param_values = ToParamValues(params);
+    // 参数仍以文本格式发送，只有结果使用指定格式
+    if (PQsendQueryPrepared(conn_.get(), stmt_name, params.size(),
+                            param_values.data(), nullptr, nullptr, static_cast<int>(result_format)) == 0) {
+        throw std::runtime_error(std::string("Failed to send prepared query: ") + PQerrorMessage(conn_.get()));
+    }
+}
+
 boost::asio::awaitable<void> PQConnection::AwaitResponse() {
     while (true) {
         // 以协程方式监听数据库给出的反馈
@@ -119,6 +227,10 @@ std::expected<PGResultPtr, DbError> PQConnection::MapResultToExpected(PGResultPt
         // 返回错误对象
         return std::unexpected(DbError{DbErrorType::SqlExecutionError, err_msg, sql_state});
     }
+    // pipeline 中前面的查询出错导致本查询被跳过 (每条查询后都有同步点，正常不会出现)
+    if (status == PGRES_PIPELINE_ABORTED) {
+        return std::unexpected(DbError{DbErrorType::SqlExecutionError, "Query skipped: pipeline aborted", ""});
+    }
     // PGRES_TUPLES_OK 代表执行成功并返回了成功的结果，比如: select
     // PGRES_COMMAND_OK 代表执行语句执行成功（没有返回结果的那种语句），比如: update、insert
     if (status == PGRES_TUPLES_OK || status == PGRES_COMMAND_OK) {
@@ -128,3 +240,164 @@ std::expected<PGResultPtr, DbError> PQConnection::MapResultToExpected(PGResultPt
     // 其他状态返回空结果集
     return PGResultPtr(nullptr, &PQclear);
 }
+
+/* pipeline 模式 */
+
+boost::asio::awaitable<std::shared_ptr<PQConnection::PipelineRequest>> PQConnection::ExecPipelinedOnStrand(
+    const char *query, const PreparedStatement *stmt, const std::vector<std::string> &params, const ResultFormat result_format) {
+    const auto self = shared_from_this();
+    auto request = std::make_shared<PipelineRequest>(strand_);
+    const auto fail = [&request](std::string reason) {
+        request->result = std::unexpected(DbError{DbErrorType::NetworkError, std::move(reason), ""});
+        return request;
+    };
+
+    if (!IsHealthy()) {
+        // 只有流水线排空后才能重连，期间到达的请求直接失败，交给上层处理
+        if (reconnecting_ || !pipeline_queue_.empty()) {
+            co_return fail("Connection is reconnecting");
+        }
+        reconnecting_ = true;
+        try {
+            co_await Reconnect();
+        } catch (const std::exception &e) {
+            reconnecting_ = false;
+            co_return fail(e.what());
+        }
+        reconnecting_ = false;
+    }
+
+    // 每条查询后跟一个同步点：出错只会中止本条查询，不会连累排在后面的其他协程
+    try {
+        if (!stmt) {
+            SendQuery(query, params);
+        } else {
+            /* 未预编译时把 Prepare 和执行放进同一个同步段，一次往返完成
+             * 在发送时就登记为已预编译，后续请求直接排在它后面执行；预编译失败时由分发逻辑撤销登记 */
+            if (!prepared_statements_.contains(std::string_view(stmt->name))) {
+                SendPrepare(*stmt, params.size());
+                prepared_statements_.emplace(stmt->name);
+                request->prepare_name = stmt->name;
+            }
+            SendQueryPrepared(stmt->name, params, result_format);
+        }
+    } catch (const std::exception &e) {
+        FailPipeline(e.what());
+        co_return fail(e.what());
+    }
+    if (PQpipelineSync(conn_.get()) == 0) {
+        const std::string reason = std::string("Failed to send pipeline sync: ") + PQerrorMessage(conn_.get());
+        FailPipeline(reason);
+        co_return fail(reason);
+    }
+
+    pipeline_queue_.push_back(request);
+    in_flight_.fetch_add(1, std::memory_order_relaxed);
+
+    // 大多数情况下一次就能写完，写不完才启动 flush 协程
+    if (!flushing_) {
+        const int flush_status = PQflush(conn_.get());
+        if (flush_status < 0) {
+            FailPipeline(std::string("Failed to flush pipeline: ") + PQerrorMessage(conn_.get()));
+        } else if (flush_status == 1) {
+            flushing_ = true;
+            boost::asio::co_spawn(strand_, FlushPipeline(), boost::asio::detached);
+        }
+    }
+    if (!reading_ && !pipeline_queue_.empty()) {
+        reading_ = true;
+        boost::asio::co_spawn(strand_, ReadPipelineResults(), boost::asio::detached);
+    }
+
+    co_await request->done.async_receive(boost::asio::use_awaitable);
+    in_flight_.fetch_sub(1, std::memory_order_relaxed);
+    co_return request;
+}
+
+boost::asio::awaitable<void> PQConnection::FlushPipeline() {
+    const auto self = shared_from_this();
+    try {
+        // 等待期间读协程仍在消费结果，服务端不会因为输出缓冲写满而卡住
+        while (true) {
+            co_await socket_.async_wait(boost::asio::posix::stream_descriptor::wait_write, boost::asio::use_awaitable);
+            const int flush_status = PQflush(conn_.get());
+            if (flush_status == 0) {
+                break;
+            }
+            if (flush_status < 0) {
+                FailPipeline(std::string("Failed to flush pipeline: ") + PQerrorMessage(conn_.get()));
+                break;
+            }
+        }
+    } catch (const std::exception &e) {
+        FailPipeline(e.what());
+    }
+    flushing_ = false;
+}
+
+boost::asio::awaitable<void> PQConnection::ReadPipelineResults() {
+    const auto self = shared_from_this();
+    try {
+        while (!pipeline_queue_.empty()) {
+            co_await socket_.async_wait(boost::asio::posix::stream_descriptor::wait_read, boost::asio::use_awaitable);
+            if (PQconsumeInput(conn_.get()) == 0) {
+                FailPipeline(std::string("Failed to consume input: ") + PQerrorMessage(conn_.get()));
+                break;
+            }
+            DispatchPipelineResults();
+        }
+    } catch (const std::exception &e) {
+        FailPipeline(e.what());
+    }
+    reading_ = false;
+}
+
+void PQConnection::DispatchPipelineResults() {
+    /* 每条查询的结果序列为：结果 -> nullptr -> PGRES_PIPELINE_SYNC
+     * 收到同步点才代表队头请求的结果已完整，PQisBusy 为 1 时说明数据还没收全，等下一次可读 */
+    bool last_was_null = false;
+    while (!pipeline_queue_.empty() && PQisBusy(conn_.get()) == 0) {
+        PGResultPtr res(PQgetResult(conn_.get()), &PQclear);
+        if (!res) {
+            // 连续两次 nullptr 说明缓冲里已经没有可取的结果了
+            if (last_was_null) {
+                break;
+            }
+            last_was_null = true;
+            continue;
+        }
+        last_was_null = false;
+
+        const auto& front = pipeline_queue_.front();
+        if (PQresultStatus(res.get()) == PGRES_PIPELINE_SYNC) {
+            if (!front->result) {
+                front->result = PGResultPtr(nullptr, &PQclear);
+            }
+            front->done.try_send(boost::system::error_code{});
+            pipeline_queue_.pop_front();
+        } else if (front->prepare_name) {
+            // 捎带的 Prepare 结果，失败时保留其错误 (随后的执行会被中止)，并撤销登记以便下次重新预编译
+            auto prepare_result = MapResultToExpected(std::move(res));
+            if (!prepare_result.has_value()) {
+                if (const auto it = prepared_statements_.find(std::string_view(front->prepare_name)); it != prepared_statements_.end()) {
+                    prepared_statements_.erase(it);
+                }
+                front->result = std::move(prepare_result);
+            }
+            front->prepare_name = nullptr;
+        } else if (!front->result) {
+            // 单语句查询，只保留第一个结果
+            front->result = MapResultToExpected(std::move(res));
+        }
+    }
+}
+
+void PQConnection::FailPipeline(const std::string &reason) {
+    SPDLOG_WARN("PostgreSQL pipeline failed, {} request(s) aborted: {}", pipeline_queue_.size(), reason);
+    pipeline_broken_ = true;
+    for (const auto& request : pipeline_queue_) {
+        request->result = std::unexpected(DbError{DbErrorType::NetworkError, reason, ""});
+        request->done.try_send(boost::system::error_code{});
+    }
+    pipeline_queue_.clear();
+}
@@ -2,7 +2,11 @@
 // Licensed under the MIT License.
 
 #include "redis_client.h"
+#include "infrastructure/asio_thread_pool/asio_thread_pool.h"
 #include <spdlog/spdlog.h>
+#include <algorithm>
+#include <numeric>
+#include <ranges>
 #include <boost/redis/request.hpp>
 #include <boost/redis/response.hpp>
 #include <boost/redis/resp3/node.hpp>
@@ -10,170 +14,538 @@
 
 using namespace user_service::infrastructure;
 
-RedisClient::RedisClient(const std::shared_ptr<boost::asio::io_context>& ioc, const RedisConfig& config):
-    ioc_(ioc) {
+namespace {
+    // 建连标记频道，不会有人往里发布消息
+    constexpr auto kConnectMarkerChannel = "__photon:near_cache:connect__";
+
+    // 单条命令最多跟随的重定向次数，超过时把最后一次的错误回复交给调用方
+    constexpr int kMaxRedirects = 3;
+
+    // 运行期新建的节点 (新增或提升的主节点) 等待首个连接可用的上限
+    constexpr std::chrono::milliseconds kNewNodeReadyTimeout{1000};
+
+    // 错误回复的文本；错误回复既可能作为值节点，也可能被适配器放进 error 中
+    std::optional<std::string_view> ErrorReplyText(const RedisReply& reply) {
+        using boost::redis::resp3::type;
+        if (reply.has_error()) {
+            const auto& error = reply.error();
+            if (error.data_type == type::simple_error || error.data_type == type::blob_error) {
+                return error.diagnostic;
+            }
+            return std::nullopt;
+        }
+        if (reply.value().data_type == type::simple_error || reply.value().data_type == type::blob_error) {
+            return reply.value().value;
+        }
+        return std::nullopt;
+    }
+}
+
+RedisClient::RedisClient(const std::shared_ptr<AsioThreadPool>& thread_pool, const RedisConfig& config):
+    thread_pool_(thread_pool),
+    node_options_{config.pool_size, config.auto_pipeline, config.pipeline_max_batch, config.exec_mode,
+                  config.mode == RedisMode::Cluster && config.replica_reads},
+    mode_(config.mode), replica_reads_(config.replica_reads), seed_{config.host, config.port},
+    replica_endpoints_(config.replicas), near_cache_(config.near_cache) {
     if (config.pool_size <= 0) {
         throw std::invalid_argument(fmt::format("Invalid Redis pool size: {}. Must be positive.", config.pool_size));
     }
     SPDLOG_DEBUG("Execute RedisClient Constructor with pool size: {}", config.pool_size);
-    cfg_.addr.host = config.host;
-    cfg_.addr.port = config.port;
-
-    // 日志等级
-    // boost::redis::logger l{boost::redis::logger::level::debug};
-    boost::redis::logger l{boost::redis::logger::level::disabled};
 
-    // 初始化连接池
-    const int size = config.pool_size;
-    conns_.reserve(size);
-    for(int i = 0; i < size; ++i) {
-        // 为每个连接绑定独立的 strand
-        conns_.emplace_back(std::make_shared<boost::redis::connection>(
-            boost::asio::make_strand(ioc->get_executor()), l));
+    if (near_cache_.Enabled()) {
+        /*
+         * setup 在每次 (重新) 建连后都会发送：
+         *  1. CLIENT TRACKING ON：服务端记住本连接读过的 key，被修改/过期/淘汰时推送 invalidate
+         *  2. SUBSCRIBE 标记频道：订阅确认同样以推送到达，收到它说明连接刚刚 (重新) 建立，
+         *     断线期间的失效通知已经丢失，必须清空近端缓存
+         */
+        cfg_.use_setup = true;
+        cfg_.setup.clear();
+        cfg_.setup.push("HELLO", "3");
+        cfg_.setup.push("CLIENT", "TRACKING", "ON");
+        cfg_.setup.push("SUBSCRIBE", kConnectMarkerChannel);
     }
-
+    std::array<int16_t, kClusterSlotCount> empty_slots{};
+    empty_slots.fill(-1);
+    topology_.store(std::make_shared<const ClusterTopology>(ClusterTopology{{}, empty_slots}));
 }
 
 RedisClient::~RedisClient() = default;
 
 
 boost::asio::awaitable<void> RedisClient::Init() {
-    SPDLOG_DEBUG("STARTING to connect redis pool (size: {})", conns_.size());
-
-    // 启动所有连接
-    for (const auto& conn : conns_) {
-        conn->async_run(cfg_, boost::asio::detached);
+    SPDLOG_DEBUG("STARTING to connect redis ({})", mode_ == RedisMode::Cluster ? "cluster" : "standalone");
+    if (near_cache_.Enabled()) {
+        SPDLOG_INFO("Redis near cache enabled with CLIENT TRACKING.");
     }
-    SPDLOG_DEBUG("Redis pool async_run started");
 
-    // 检查每个的连接状态
-    for (size_t i = 0; i < conns_.size(); ++i) {
-        const auto ping_res = co_await Ping(conns_[i]);
-        if (!ping_res.has_value()) {
-            std::string err_msg = fmt::format("Redis Pool Init failed at connection [{}]: {}", i, ping_res.error().message);
-            SPDLOG_CRITICAL("{}", err_msg);
-            // 启动阶段抛异常
-            throw std::runtime_error(err_msg);
+    if (mode_ == RedisMode::Standalone) {
+        primary_ = GetOrCreateNode(seed_);
+        co_await primary_->WaitReady();
+        if (replica_reads_) {
+            // 副本是可选的，不阻塞启动：GetOrCreateNode 已启动连接，探测成功后自然加入，在此之前读主节点
+            for (const auto& endpoint : replica_endpoints_) {
+                replicas_.push_back(GetOrCreateNode(endpoint));
+            }
         }
+        SPDLOG_INFO("Redis standalone (replicas: {}) Init successfully.", replicas_.size());
+        co_return;
     }
 
-    SPDLOG_INFO("Redis Pool (size: {}) Init successfully.", conns_.size());
+    co_await GetOrCreateNode(seed_)->WaitReady();
+    if (!co_await RefreshTopology(true)) {
+        const std::string err_msg = fmt::format("Redis cluster Init failed: cannot load CLUSTER SLOTS from {}:{}",
+                                                seed_.host, seed_.port);
+        SPDLOG_CRITICAL("{}", err_msg);
+        // 启动阶段抛异常
+        throw std::runtime_error(err_msg);
+    }
+    const auto topology = topology_.load();
+    const auto uncovered = std::ranges::count(topology->slot_to_shard, static_cast<int16_t>(-1));
+    if (uncovered > 0) {
+        SPDLOG_WARN("Redis cluster has {} uncovered slots, requests on them go to the seed node", uncovered);
+    }
+    SPDLOG_INFO("Redis cluster (shards: {}) Init successfully.", topology->shards.size());
 }
 
 boost::asio::awaitable<std::expected<void, RedisError>> RedisClient::Set(const std::string& key, const std::string& value) const {
-    SPDLOG_DEBUG("SET {}: {}", key, value);
-    try {
-        boost::redis::request req;
-        req.push("SET", key, value);
+    co_return co_await Set(key, value, std::chrono::seconds(0));
+}
 
-        const auto conn = GetNextConnection();
+boost::asio::awaitable<std::expected<void, RedisError>> RedisClient::Set(const std::string& key,
+    const std::string& value, const std::chrono::seconds& expiry) const {
+    SPDLOG_DEBUG("SET {}: {} (Expiry: {}s)", key, value, expiry.count());
+    RedisCommand command{"SET", {key, value}};
+    if (expiry.count() > 0) {
+        command.args.emplace_back("EX");
+        command.args.push_back(std::to_string(expiry.count()));
+    }
+    const auto reply = co_await Execute(std::move(command), key, RedisRoute::Write);
+    // 服务端也会推送失效，这里先删掉，保证本进程随后的读能看到自己的写
+    InvalidateNearCache(key);
 
-        // 进入串行区
-        co_await boost::asio::post(conn->get_executor(), boost::asio::use_awaitable);
-        co_await conn->async_exec(req, boost::redis::ignore, boost::asio::use_awaitable);
+    if (auto result = ExtractResult(reply, "SET", key); !result.has_value()) {
+        co_return std::unexpected(std::move(result.error()));
+    }
+    co_return std::expected<void, RedisError>();
+}
 
-        co_return std::expected<void, RedisError>();
-    } catch (const std::exception& e) {
-        // 与 redis 断开连接
-        SPDLOG_ERROR("Redis SET failed: {}. Key: {}, Value: {}", e.what(), key, value);
-        co_return std::unexpected(RedisError{
-            RedisErrorType::SystemError,
-            fmt::format("SET exception: {}", e.what())
-        });
+boost::asio::awaitable<std::expected<std::optional<std::string>, RedisError>> RedisClient::Get(const std::string& key) const {
+    SPDLOG_DEBUG("GET {}", key);
+    if (auto cached = near_cache_.Get(key); cached.has_value()) {
+        co_return std::move(cached);
     }
+    // 必须在发出 GET 之前取纪元
+    const uint64_t epoch = invalidation_epoch_.load();
+
+    auto result = ExtractResult(co_await Execute(RedisCommand{"GET", {key}}, key, RedisRoute::Read), "GET", key);
+    if (near_cache_.Enabled() && result.has_value() && result.value().has_value()) {
+        // 先写入再复查：复查时纪元未变，则之后的失效一定会删掉这次写入；纪元变了就撤回
+        near_cache_.Put(key, result.value().value());
+        if (invalidation_epoch_.load() != epoch) {
+            near_cache_.Erase(key);
+        }
+    }
+    co_return result;
 }
 
-boost::asio::awaitable<std::expected<void, RedisError>> RedisClient::Set(const std::string& key,
-    const std::string& value, const std::chrono::seconds& expiry) const {
-    SPDLOG_DEBUG("SET {}: {} (Expiry: {}s)", key, value, expiry.count());
-    try {
-        boost::redis::request req;
-        if (expiry.count() > 0) {
-            req.push("SET", key, value, "EX", std::to_string(expiry.count()));
+boost::asio::awaitable<std::expected<std::vector<std::optional<std::string>>, RedisError>> RedisClient::MGet(
+    const std::vector<std::string>& keys) const {
+    SPDLOG_DEBUG("MGET {} keys", keys.size());
+    std::vector<std::optional<std::string>> values(keys.size());
+
+    // 近端缓存命中的 key 不再发给 Redis
+    std::vector<size_t> missing;
+    missing.reserve(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (auto cached = near_cache_.Get(keys[i]); cached.has_value()) {
+            values[i] = std::move(cached);
         } else {
-            req.push("SET", key, value);
+            missing.push_back(i);
         }
+    }
+    if (missing.empty()) {
+        co_return values;
+    }
 
-        const auto conn = GetNextConnection();
+    std::vector<std::string_view> missing_keys;
+    missing_keys.reserve(missing.size());
+    for (const size_t i : missing) {
+        missing_keys.emplace_back(keys[i]);
+    }
 
-        // 进入串行区
-        co_await boost::asio::post(conn->get_executor(), boost::asio::use_awaitable);
-        co_await conn->async_exec(req, boost::redis::ignore, boost::asio::use_awaitable);
+    const uint64_t epoch = invalidation_epoch_.load();
+    for (const auto& [node, positions] : GroupByNode(missing_keys, RedisRoute::Read)) {
+        const std::string context = fmt::format("{} keys", positions.size());
+        /*
+         * Standalone：一条 MGET，回复平铺为数组头 + 每个 key 一个节点
+         * Cluster：同一节点上的 key 可能属于不同的槽，MGET 会 CROSSSLOT，改为流水线的多条 GET，每个 key 一个深度 0 节点
+         */
+        auto req = MakeFailFastRequest();
+        if (mode_ == RedisMode::Standalone) {
+            std::vector<std::string_view> group_keys;
+            group_keys.reserve(positions.size());
+            for (const size_t j : positions) {
+                group_keys.push_back(missing_keys[j]);
+            }
+            req.push_range("MGET", group_keys);
+        } else {
+            for (const size_t j : positions) {
+                req.push("GET", missing_keys[j]);
+            }
+        }
+        const auto resp = co_await node->ExecuteRequest(req);
+        if (resp.has_error()) {
+            if (mode_ == RedisMode::Standalone) {
+                co_return std::unexpected(ToRedisError(resp.error(), "MGET", context));
+            }
+            // 多半是迁移中的槽 (MOVED/ASK)，逐个 key 走带重定向的单条路径
+            for (const size_t j : positions) {
+                const auto& key = keys[missing[j]];
+                auto result = ExtractResult(co_await Execute(RedisCommand{"GET", {key}}, key, RedisRoute::Read), "GET", key);
+                if (!result.has_value()) {
+                    co_return std::unexpected(std::move(result.error()));
+                }
+                if (result.value().has_value()) {
+                    near_cache_.Put(key, result.value().value());
+                    values[missing[j]] = std::move(result.value());
+                }
+            }
+            continue;
+        }
 
-        co_return std::expected<void, RedisError>();
-    } catch (const std::exception& e) {
-        // 与 redis 断开连接
-        SPDLOG_ERROR("Redis SET Exception: {}", e.what());
-        co_return std::unexpected(RedisError{
-            RedisErrorType::SystemError,
-            fmt::format("SET exception: {} (Key: {})", e.what(), key)
-        });
+        const auto& nodes = resp.value();
+        const size_t offset = mode_ == RedisMode::Standalone ? 1 : 0;
+        if (nodes.size() != positions.size() + offset || (offset == 1 && nodes[0].aggregate_size != positions.size())) {
+            const std::string msg = fmt::format("Redis MGET Protocol Error: expected {} elements, got {}. Context: {}",
+                                                positions.size(), nodes.size() - std::min(nodes.size(), offset), context);
+            SPDLOG_WARN("{}", msg);
+            co_return std::unexpected(RedisError{RedisErrorType::ProtocolError, msg});
+        }
+        for (size_t k = 0; k < positions.size(); ++k) {
+            const auto& reply = nodes[k + offset];
+            if (reply.data_type == boost::redis::resp3::type::blob_string) {
+                const size_t i = missing[positions[k]];
+                values[i] = reply.value;
+                near_cache_.Put(keys[i], reply.value);
+            }
+        }
+    }
+    // 与 Get 相同：写入后复查纪元，期间有失效则撤回本次写入的全部 key
+    if (near_cache_.Enabled() && invalidation_epoch_.load() != epoch) {
+        for (const size_t i : missing) {
+            near_cache_.Erase(keys[i]);
+        }
     }
+    co_return values;
 }
 
-boost::asio::awaitable<std::expected<std::optional<std::string>, RedisError>> RedisClient::Get(const std::string& key) const {
-    SPDLOG_DEBUG("GET {}", key);
-    try {
-        boost::redis::request req;
-        req.push("GET", key);
-
-        boost::redis::response<boost::redis::resp3::node> resp;
+boost::asio::awaitable<std::expected<void, RedisError>> RedisClient::MSet(const std::vector<RedisSetEntry>& entries) const {
+    SPDLOG_DEBUG("MSET {} keys", entries.size());
+    if (entries.empty()) {
+        co_return std::expected<void, RedisError>();
+    }
+    std::vector<std::string_view> entry_keys;
+    entry_keys.reserve(entries.size());
+    for (const auto& entry : entries) {
+        entry_keys.emplace_back(entry.key);
+    }
 
-        const auto conn = GetNextConnection();
+    std::expected<void, RedisError> outcome;
+    for (const auto& [node, positions] : GroupByNode(entry_keys, RedisRoute::Write)) {
+        auto req = MakeFailFastRequest();
+        for (const size_t i : positions) {
+            const auto& entry = entries[i];
+            if (entry.ttl.count() > 0) {
+                req.push("SET", entry.key, entry.value, "EX", std::to_string(entry.ttl.count()));
+            } else {
+                req.push("SET", entry.key, entry.value);
+            }
+        }
+        const auto resp = co_await node->ExecuteRequest(req);
+        if (!resp.has_error()) {
+            continue;
+        }
+        if (mode_ == RedisMode::Standalone) {
+            outcome = std::unexpected(ToRedisError(resp.error(), "MSET", fmt::format("{} keys", positions.size())));
+            break;
+        }
+        // 与 MGet 相同，逐个 key 重试
+        for (const size_t i : positions) {
+            const auto& entry = entries[i];
+            RedisCommand command{"SET", {entry.key, entry.value}};
+            if (entry.ttl.count() > 0) {
+                command.args.emplace_back("EX");
+                command.args.push_back(std::to_string(entry.ttl.count()));
+            }
+            if (auto result = ExtractResult(co_await Execute(std::move(command), entry.key, RedisRoute::Write), "SET", entry.key);
+                !result.has_value() && outcome.has_value()) {
+                outcome = std::unexpected(std::move(result.error()));
+            }
+        }
+    }
+    for (const auto& entry : entries) {
+        InvalidateNearCache(entry.key);
+    }
+    co_return outcome;
+}
 
-        // 进入串行区
-        co_await boost::asio::post(conn->get_executor(), boost::asio::use_awaitable);
-        co_await conn->async_exec(req, resp, boost::asio::use_awaitable);
+boost::asio::awaitable<std::expected<int64_t, RedisError>> RedisClient::Del(const std::vector<std::string>& keys) const {
+    SPDLOG_DEBUG("DEL {} keys", keys.size());
+    if (keys.empty()) {
+        co_return 0;
+    }
+    int64_t deleted = 0;
+    std::optional<RedisError> failure;
+    if (mode_ == RedisMode::Standalone) {
+        // Standalone 一条 DEL
+        const std::string context = fmt::format("{} keys", keys.size());
+        const auto reply = co_await Execute(RedisCommand{"DEL", keys}, {}, RedisRoute::Write, false);
+        if (reply.has_value() && reply.value().data_type == boost::redis::resp3::type::number) {
+            deleted = std::stoll(reply.value().value);
+        } else if (auto result = ExtractResult(reply, "DEL", context); !result.has_value()) {
+            failure = std::move(result.error());
+        } else {
+            failure = RedisError{RedisErrorType::ProtocolError,
+                fmt::format("Redis DEL Protocol Error: integer reply expected. Context: {}", context)};
+        }
+    } else {
+        /*
+         * Cluster 每个 key 一条 DEL (避免 CROSSSLOT)，逐条走带重定向的单条路径，且不进自动流水线：
+         * DEL 的回复取决于执行前 key 是否存在，流水线出错后无法知道哪些已经生效，重放会把删除数少算
+         */
+        for (const auto& key : keys) {
+            const auto reply = co_await Execute(RedisCommand{"DEL", {key}}, key, RedisRoute::Write, false);
+            if (reply.has_value() && reply.value().data_type == boost::redis::resp3::type::number) {
+                deleted += std::stoll(reply.value().value);
+                continue;
+            }
+            if (auto result = ExtractResult(reply, "DEL", key); !result.has_value()) {
+                failure = std::move(result.error());
+            } else {
+                failure = RedisError{RedisErrorType::ProtocolError,
+                    fmt::format("Redis DEL Protocol Error: integer reply expected. Context: {}", key)};
+            }
+        }
+    }
+    for (const auto& key : keys) {
+        InvalidateNearCache(key);
+    }
+    if (failure.has_value()) {
+        co_return std::unexpected(std::move(failure.value()));
+    }
+    co_return deleted;
+}
 
-        co_return ExtractResult(std::get<0>(resp), "GET", key);
-    } catch (const std::exception& e) {
-        // 与 redis 断开连接
-        SPDLOG_ERROR("Redis GET Exception: {}", e.what());
-        co_return std::unexpected(RedisError{
-            RedisErrorType::SystemError,
-            fmt::format("GET exception: {} (Key: {})", e.what(), key)
-        });
+boost::asio::awaitable<RedisReply> RedisClient::Execute(RedisCommand command, const std::string_view key,
+                                                        const RedisRoute route, const bool batchable) const {
+    auto node = NodeForKey(key, route);
+    if (mode_ == RedisMode::Standalone) {
+        co_return co_await node->Execute(command, batchable);
+    }
+    for (int redirects = 0; ; ++redirects) {
+        auto reply = co_await node->Execute(command, batchable);
+        const auto error_text = ErrorReplyText(reply);
+        const auto redirect = error_text.has_value() ? ParseRedirect(error_text.value()) : std::nullopt;
+        if (!redirect.has_value() || redirects >= kMaxRedirects) {
+            co_return reply;
+        }
+        node = GetOrCreateNode(redirect->target);
+        // 目标可能是刚发现的节点，连接还不在轮换中；超时仍然发出，按连接失败返回
+        co_await node->WaitInitialReady(kNewNodeReadyTimeout);
+        if (!redirect->ask) {
+            // 槽已迁移：本条命令直接转发，拓扑在后台整体刷新
+            SPDLOG_DEBUG("Redis MOVED slot {} to {}", redirect->slot, node->Name());
+            ScheduleTopologyRefresh();
+            continue;
+        }
+        // 槽迁移中：只有紧跟在 ASKING 之后的一条命令会被目标节点接受，两者放在同一个 request 里
+        SPDLOG_DEBUG("Redis ASK slot {} at {}", redirect->slot, node->Name());
+        auto req = MakeFailFastRequest();
+        req.push("ASKING");
+        req.push_range(command.name, command.args);
+        const auto resp = co_await node->ExecuteRequest(req);
+        if (resp.has_error()) {
+            co_return RedisReply{resp.error()};
+        }
+        // 回复平铺为：ASKING 的 OK + 命令回复
+        if (resp.value().size() != 2) {
+            co_return RedisReply{boost::redis::adapter::error{boost::redis::resp3::type::invalid,
+                fmt::format("unexpected ASK reply size {}", resp.value().size())}};
+        }
+        co_return RedisReply{resp.value()[1]};
     }
 }
 
-boost::asio::awaitable<std::expected<void, RedisError>> RedisClient::Ping(const std::shared_ptr<boost::redis::connection>& conn) const {
-    try {
-        boost::redis::request req;
-        req.push("PING");
+std::vector<std::pair<std::shared_ptr<RedisNode>, std::vector<size_t>>> RedisClient::GroupByNode(
+    const std::vector<std::string_view>& keys, const RedisRoute route) const {
+    std::vector<std::pair<std::shared_ptr<RedisNode>, std::vector<size_t>>> groups;
+    if (mode_ == RedisMode::Standalone) {
+        std::vector<size_t> all(keys.size());
+        std::iota(all.begin(), all.end(), 0);
+        groups.emplace_back(NodeForKey({}, route), std::move(all));
+        return groups;
+    }
+    // 节点数很少，线性查找即可
+    for (size_t i = 0; i < keys.size(); ++i) {
+        auto node = NodeForKey(keys[i], route);
+        const auto it = std::ranges::find_if(groups, [&node](const auto& group) { return group.first == node; });
+        if (it != groups.end()) {
+            it->second.push_back(i);
+        } else {
+            groups.emplace_back(std::move(node), std::vector<size_t>{i});
+        }
+    }
+    return groups;
+}
 
-        boost::redis::response<boost::redis::resp3::node> resp;
+std::shared_ptr<RedisNode> RedisClient::NodeForKey(const std::string_view key, const RedisRoute route) const {
+    const bool read_replica = route == RedisRoute::Read && replica_reads_;
+    if (mode_ == RedisMode::Standalone) {
+        if (read_replica) {
+            if (auto replica = PickReplica(replicas_)) {
+                return replica;
+            }
+        }
+        return primary_;
+    }
+    const auto topology = topology_.load();
+    const int16_t shard_index = topology->slot_to_shard[KeyHashSlot(key)];
+    if (shard_index < 0) {
+        return GetOrCreateNode(seed_);
+    }
+    const auto& shard = topology->shards[shard_index];
+    if (read_replica) {
+        if (auto replica = PickReplica(shard.replicas)) {
+            return replica;
+        }
+    }
+    return shard.primary;
+}
 
-        // 进入串行区
-        co_await boost::asio::post(conn->get_executor(), boost::asio::use_awaitable);
-        co_await conn->async_exec(req, resp, boost::asio::use_awaitable);
+std::shared_ptr<RedisNode> RedisClient::PickReplica(const std::vector<std::shared_ptr<RedisNode>>& replicas) const {
+    if (replicas.empty()) {
+        return nullptr;
+    }
+    const size_t start = replica_counter_.fetch_add(1, std::memory_order_relaxed);
+    for (size_t k = 0; k < replicas.size(); ++k) {
+        const auto& replica = replicas[(start + k) % replicas.size()];
+        if (replica->HasHealthyConnection()) {
+            return replica;
+        }
+    }
+    // 副本全部不可用时读主节点
+    return nullptr;
+}
 
-        auto result = ExtractResult(std::get<0>(resp), "PING", "Init");
+boost::asio::awaitable<bool> RedisClient::RefreshTopology(const bool wait_ready) const {
+    // 候选：当前拓扑中的主节点，最后是种子节点
+    std::vector<std::shared_ptr<RedisNode>> candidates;
+    for (const auto& shard : topology_.load()->shards) {
+        candidates.push_back(shard.primary);
+    }
+    candidates.push_back(GetOrCreateNode(seed_));
 
-        if (!result.has_value()) {
-            co_return std::unexpected(result.error());
+    for (const auto& candidate : candidates) {
+        if (!candidate->HasHealthyConnection()) {
+            continue;
+        }
+        auto req = MakeFailFastRequest();
+        req.push("CLUSTER", "SLOTS");
+        const auto resp = co_await candidate->ExecuteRequest(req);
+        if (resp.has_error()) {
+            SPDLOG_WARN("Redis CLUSTER SLOTS on {} failed: {}", candidate->Name(), resp.error().diagnostic);
+            continue;
+        }
+        const auto ranges = ParseClusterSlots(resp.value(), candidate->Host());
+        if (!ranges.has_value()) {
+            SPDLOG_WARN("Redis CLUSTER SLOTS on {} returned an unexpected reply", candidate->Name());
+            continue;
         }
 
-        // 检查 PING 返回值
-        const auto& opt_val = result.value();
-
-        // PING 必须返回 "PONG"
-        if (opt_val.has_value() && opt_val.value() == "PONG") {
-            SPDLOG_DEBUG("Redis PING successful.");
-            co_return std::expected<void, RedisError>(); // 成功
+        auto topology = std::make_shared<ClusterTopology>();
+        topology->slot_to_shard.fill(-1);
+        for (const auto& range : ranges.value()) {
+            auto primary = GetOrCreateNode(range.primary);
+            auto it = std::ranges::find_if(topology->shards, [&primary](const ClusterShard& shard) {
+                return shard.primary == primary;
+            });
+            if (it == topology->shards.end()) {
+                ClusterShard shard{primary, {}};
+                for (const auto& replica : range.replicas) {
+                    shard.replicas.push_back(GetOrCreateNode(replica));
+                }
+                topology->shards.push_back(std::move(shard));
+                it = std::prev(topology->shards.end());
+            }
+            const auto shard_index = static_cast<int16_t>(it - topology->shards.begin());
+            std::fill(topology->slot_to_shard.begin() + range.start, topology->slot_to_shard.begin() + range.end + 1,
+                      shard_index);
+        }
+        // 副本不等待，探测成功后自然加入
+        bool primaries_ready = true;
+        for (const auto& shard : topology->shards) {
+            if (wait_ready) {
+                co_await shard.primary->WaitReady();
+            } else if (!co_await shard.primary->WaitInitialReady(kNewNodeReadyTimeout)) {
+                primaries_ready = false;
+            }
         }
+        if (!primaries_ready) {
+            // 不换上主节点还连不上的拓扑，保留旧拓扑继续跟随重定向，下次 MOVED 时再刷新
+            SPDLOG_WARN("Redis cluster topology from {} has primaries not ready yet, keep the current one", candidate->Name());
+            co_return false;
+        }
+        SPDLOG_INFO("Redis cluster topology loaded from {}: {} shards", candidate->Name(), topology->shards.size());
+        topology_.store(std::move(topology));
+        co_return true;
+    }
+    co_return false;
+}
 
-        // 走到这里说明返回了 Null 或者不是 PONG
-        std::string val = opt_val.value_or("NULL");
-        std::string msg = fmt::format("Redis PING protocol error. Expected 'PONG', got '{}'", val);
-        SPDLOG_ERROR("{}", msg);
+void RedisClient::ScheduleTopologyRefresh() const {
+    if (refreshing_.exchange(true)) {
+        return;
+    }
+    boost::asio::co_spawn(thread_pool_->GetIOContext(0)->get_executor(), [this]() -> boost::asio::awaitable<void> {
+        if (!co_await RefreshTopology(false)) {
+            SPDLOG_WARN("Redis cluster topology refresh failed, keep following redirects");
+        }
+        refreshing_.store(false);
+    }, boost::asio::detached);
+}
 
-        co_return std::unexpected(RedisError{RedisErrorType::ProtocolError, msg});
+std::shared_ptr<RedisNode> RedisClient::GetOrCreateNode(const RedisEndpoint& endpoint) const {
+    const std::string name = fmt::format("{}:{}", endpoint.host, endpoint.port);
+    std::shared_ptr<RedisNode> node;
+    {
+        std::lock_guard lock(nodes_mutex_);
+        if (const auto it = nodes_.find(name); it != nodes_.end()) {
+            return it->second;
+        }
+        auto cfg = cfg_;
+        cfg.addr.host = endpoint.host;
+        cfg.addr.port = endpoint.port;
+        node = std::make_shared<RedisNode>(thread_pool_, std::move(cfg), node_options_);
+        nodes_.emplace(name, node);
+    }
+    // 推送处理只在开启近端缓存时需要
+    RedisPushHandler handler;
+    if (near_cache_.Enabled()) {
+        handler = [this](const std::vector<boost::redis::resp3::node>& nodes) { HandlePushes(nodes); };
+    }
+    node->Start(std::move(handler));
+    return node;
+}
 
-    } catch (const std::exception& e) {
-        std::string msg = fmt::format("Redis PING exception: {}", e.what());
-        SPDLOG_ERROR("{}", msg);
-        co_return std::unexpected(RedisError{RedisErrorType::SystemError, msg});
+std::vector<RedisConnectionStats> RedisClient::GetConnectionStats() const {
+    std::vector<RedisConnectionStats> stats;
+    std::lock_guard lock(nodes_mutex_);
+    for (const auto& node : nodes_ | std::views::values) {
+        auto node_stats = node->GetConnectionStats();
+        stats.insert(stats.end(), node_stats.begin(), node_stats.end());
     }
+    return stats;
 }
 
 std::expected<std::optional<std::string>, RedisError> RedisClient::ExtractResult(
@@ -218,9 +590,62 @@ std::expected<std::optional<std::string>, RedisError> RedisClient::ExtractResult
     return std::unexpected(RedisError{RedisErrorType::ProtocolError, msg});
 }
 
-std::shared_ptr<boost::redis::connection> RedisClient::GetNextConnection() const {
-    // 原子递增取模，实现 Round-Robin 策略
-    const size_t idx = request_counter_.fetch_add(1, std::memory_order_relaxed) % conns_.size();
-    SPDLOG_DEBUG("Get the {} redis conn", idx);
-    return conns_[idx];
-}
\ No newline at end of file
+void RedisClient::HandlePushes(const std::vector<boost::redis::resp3::node>& nodes) const {
+    using boost::redis::resp3::type;
+    // 推送流中断或解析失败，无法确定哪些 key 失效了
+    if (nodes.empty()) {
+        InvalidateAllNearCache();
+        return;
+    }
+    // 一次可能收到多条推送，每条以深度 0 的 push 节点开头
+    size_t begin = 0;
+    while (begin < nodes.size()) {
+        size_t end = begin + 1;
+        while (end < nodes.size() && nodes[end].depth > 0) {
+            ++end;
+        }
+        if (nodes[begin].data_type == type::push && end - begin >= 3) {
+            const auto& kind = nodes[begin + 1].value;
+            if (kind == "invalidate") {
+                // >2 invalidate *N key...；FLUSHALL/FLUSHDB 时 key 列表为 null
+                if (nodes[begin + 2].data_type == type::null) {
+                    InvalidateAllNearCache();
+                } else {
+                    for (size_t i = begin + 3; i < end; ++i) {
+                        InvalidateNearCache(nodes[i].value);
+                    }
+                }
+            } else if (kind == "subscribe") {
+                SPDLOG_INFO("Redis connection (re)established, near cache cleared.");
+                InvalidateAllNearCache();
+            }
+        }
+        begin = end;
+    }
+}
+
+void RedisClient::InvalidateNearCache(const std::string& key) const {
+    if (!near_cache_.Enabled()) {
+        return;
+    }
+    invalidation_epoch_.fetch_add(1);
+    near_cache_.Erase(key);
+}
+
+void RedisClient::InvalidateAllNearCache() const {
+    if (!near_cache_.Enabled()) {
+        return;
+    }
+    invalidation_epoch_.fetch_add(1);
+    near_cache_.Clear();
+}
+
+RedisError RedisClient::ToRedisError(const boost::redis::adapter::error& error, const std::string& command_name,
+                                     const std::string& context) {
+    const bool is_reply_error = error.data_type == boost::redis::resp3::type::simple_error ||
+                                error.data_type == boost::redis::resp3::type::blob_error;
+    const std::string msg = fmt::format("Redis {} {}: {}. Context: {}", command_name,
+                                        is_reply_error ? "Command Error" : "failed", error.diagnostic, context);
+    SPDLOG_ERROR("{}", msg);
+    return RedisError{is_reply_error ? RedisErrorType::CommandError : RedisErrorType::SystemError, msg};
+}
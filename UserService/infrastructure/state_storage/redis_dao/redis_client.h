@@ -2,12 +2,22 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <array>
 #include <string>
 #include <expected>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
 #include <boost/redis/connection.hpp>
+#include <boost/redis/response.hpp>
 #include <boost/asio.hpp>
+#include "infrastructure/local_cache/sharded_lru_cache.h"
+#include "infrastructure/state_storage/redis_dao/redis_command_batcher.h"
+#include "infrastructure/state_storage/redis_dao/redis_cluster.h"
+#include "infrastructure/state_storage/redis_dao/redis_node.h"
 
 namespace user_service::infrastructure {
+    class AsioThreadPool;
 
     enum class RedisErrorType {
         SystemError,
@@ -20,26 +30,56 @@ namespace user_service::infrastructure {
         std::string message;
     };
 
+    // MSet 的一项，ttl 为 0 表示不过期
+    struct RedisSetEntry {
+        std::string key;
+        std::string value;
+        std::chrono::seconds ttl;
+    };
+
+    enum class RedisMode {
+        Standalone,     // 单主节点，可选若干只读副本
+        Cluster         // Redis Cluster，host/port 作为种子节点，拓扑由 CLUSTER SLOTS 获得
+    };
+
     struct RedisConfig {
         std::string host;
         std::string port;
+        // 每个节点的连接数
         int pool_size;
+        RedisMode mode = RedisMode::Standalone;
+        // 读命令 (GET/MGET) 发往副本；Standalone 模式使用 replicas，Cluster 模式使用各分片的副本
+        bool replica_reads = false;
+        std::vector<RedisEndpoint> replicas;
+        // 近端缓存 (client-side caching)：GET 结果留在进程内，靠 RESP3 CLIENT TRACKING 的失效推送保持一致
+        LocalCacheConfig near_cache;
+        // 自动流水线：同一 tick 内发往同一连接的命令合并为一个 request
+        bool auto_pipeline = false;
+        size_t pipeline_max_batch = 64;
+        RedisExecMode exec_mode = RedisExecMode::Dispatch;
     };
 
     class RedisClient {
     public:
-        RedisClient(const std::shared_ptr<boost::asio::io_context>& ioc, const RedisConfig& config);
+        RedisClient(const std::shared_ptr<AsioThreadPool>& thread_pool, const RedisConfig& config);
         ~RedisClient();
         boost::asio::awaitable<void> Init();
         boost::asio::awaitable<std::expected<void, RedisError>> Set(const std::string& key, const std::string& value) const;
         boost::asio::awaitable<std::expected<void, RedisError>> Set(const std::string& key, const std::string& value, const std::chrono::seconds& expiry) const;
         boost::asio::awaitable<std::expected<std::optional<std::string>, RedisError>> Get(const std::string& key) const;
+
+        // 批量读取 (MGET)，结果与 keys 一一对应，不存在的 key 为 nullopt
+        boost::asio::awaitable<std::expected<std::vector<std::optional<std::string>>, RedisError>> MGet(
+            const std::vector<std::string>& keys) const;
+        // 批量写入：每项一条 SET [EX]，合并在同一个流水线请求里，因此每个 key 可以有自己的过期时间
+        boost::asio::awaitable<std::expected<void, RedisError>> MSet(const std::vector<RedisSetEntry>& entries) const;
+        // 返回实际删除的 key 数
+        boost::asio::awaitable<std::expected<int64_t, RedisError>> Del(const std::vector<std::string>& keys) const;
+
+        [[nodiscard]] LocalCacheStats GetNearCacheStats() const { return near_cache_.GetStats(); }
+        // 所有节点的全部连接，按节点分组
+        [[nodiscard]] std::vector<RedisConnectionStats> GetConnectionStats() const;
     private:
-        /*
-         * 注意：此时 Ping 只是在 Init 中被调用，理论上没有线程安全问题，但是为了防止后续被多线程环境使用，对函数内部进行了安全处理
-         */
-        // 等待联通
-        boost::asio::awaitable<std::expected<void, RedisError>> Ping(const std::shared_ptr<boost::redis::connection>& conn) const;
 
         /*
          * 注意：这个函数目前工作量不大，所以和 conn->async_exec 一起在 strand 串行区进行处理。
@@ -51,17 +91,97 @@ namespace user_service::infrastructure {
             const boost::system::result<boost::redis::resp3::node, boost::redis::adapter::error>& result,
             const std::string& command_name, const std::string& key_context= "");
 
-        // 获取下一个连接 (Round-Robin 策略)
-        std::shared_ptr<boost::redis::connection> GetNextConnection() const;
+        // 读命令可以发往副本，写命令只发往主节点
+        enum class RedisRoute {
+            Read,
+            Write
+        };
+
+        /*
+         * 按 key 路由并执行单条命令
+         * Cluster 模式下处理重定向：MOVED 后刷新拓扑并转发到新节点，ASK 则在目标节点上以 ASKING + 命令执行一次
+         * batchable 含义同 RedisNode::Execute
+         */
+        boost::asio::awaitable<RedisReply> Execute(RedisCommand command, std::string_view key, RedisRoute route,
+                                                   bool batchable = true) const;
 
+        // 把 keys 按负责的节点分组 (Standalone 模式下只有一组)，组内保持原有顺序，值为 keys 的下标
+        [[nodiscard]] std::vector<std::pair<std::shared_ptr<RedisNode>, std::vector<size_t>>> GroupByNode(
+            const std::vector<std::string_view>& keys, RedisRoute route) const;
 
-        const std::shared_ptr<boost::asio::io_context> ioc_;
-        // 维护连接池
-        std::vector<std::shared_ptr<boost::redis::connection>> conns_;
-        // std::shared_ptr<boost::redis::connection> conn_;
+        // 负责 key 的节点；Cluster 模式下槽未被覆盖 (拓扑不完整) 时退回种子节点，由重定向纠正
+        [[nodiscard]] std::shared_ptr<RedisNode> NodeForKey(std::string_view key, RedisRoute route) const;
+
+        /* Cluster 拓扑 */
+        struct ClusterShard {
+            std::shared_ptr<RedisNode> primary;
+            std::vector<std::shared_ptr<RedisNode>> replicas;
+        };
+        // 不可变快照，整体替换 (copy-on-write)，读路径只有一次原子 load
+        struct ClusterTopology {
+            std::vector<ClusterShard> shards;
+            // 槽 -> shards 下标，-1 表示未覆盖
+            std::array<int16_t, kClusterSlotCount> slot_to_shard;
+        };
+
+        /*
+         * 以任一可用主节点执行 CLUSTER SLOTS 并替换拓扑，成功返回 true；新出现的节点会被创建并启动
+         * wait_ready 为 true (启动阶段) 时等待主节点全部连接连通，失败抛出异常；
+         * 否则限时等待新主节点的首个连接，有主节点未就绪时保留旧拓扑并返回 false
+         */
+        boost::asio::awaitable<bool> RefreshTopology(bool wait_ready) const;
+        // 收到 MOVED 后在后台刷新，同一时间最多一个
+        void ScheduleTopologyRefresh() const;
+
+        /*
+         * 按地址取节点，不存在时创建并启动。节点创建后不再销毁，探测/推送协程持有的引用始终有效
+         * Cluster 模式开启副本读时所有节点都发送 READONLY：主节点上无副作用，故障切换后角色互换也不必重建连接
+         */
+        std::shared_ptr<RedisNode> GetOrCreateNode(const RedisEndpoint& endpoint) const;
+
+        // 从若干副本中选一个有健康连接的，都不可用时返回 nullptr
+        [[nodiscard]] std::shared_ptr<RedisNode> PickReplica(const std::vector<std::shared_ptr<RedisNode>>& replicas) const;
+
+        // generic_response 的错误转换为 RedisError：错误回复为 CommandError，其余为 SystemError
+        [[nodiscard]] static RedisError ToRedisError(const boost::redis::adapter::error& error,
+                                                     const std::string& command_name, const std::string& context);
+
+        /* 近端缓存 */
+        // 处理一批推送消息 (按深度 0 的节点切分)，作为每个节点的推送处理函数
+        void HandlePushes(const std::vector<boost::redis::resp3::node>& nodes) const;
+
+        // 淘汰近端缓存：先推进纪元，再删除，与 Get 中"先写入再复查纪元"配合
+        void InvalidateNearCache(const std::string& key) const;
+        void InvalidateAllNearCache() const;
+
+
+        const std::shared_ptr<AsioThreadPool> thread_pool_;
+        // 所有节点共用的连接配置 (地址除外)
         boost::redis::config cfg_;
+        const RedisNodeOptions node_options_;
+        const RedisMode mode_;
+        const bool replica_reads_;
+        // Standalone 模式下为主节点，Cluster 模式下为种子节点
+        const RedisEndpoint seed_;
+        const std::vector<RedisEndpoint> replica_endpoints_;
+
+        // Standalone 模式，Init 中创建
+        std::shared_ptr<RedisNode> primary_;
+        std::vector<std::shared_ptr<RedisNode>> replicas_;
+
+        // Cluster 模式
+        mutable std::atomic<std::shared_ptr<const ClusterTopology>> topology_;
+        mutable std::atomic<bool> refreshing_{false};
+        // 已创建的全部节点 (host:port -> 节点)，包括已不在拓扑中的
+        mutable std::mutex nodes_mutex_;
+        mutable std::unordered_map<std::string, std::shared_ptr<RedisNode>> nodes_;
+
+        // 副本轮询计数器 (mutable 允许在 const 函数中修改)
+        mutable std::atomic<size_t> replica_counter_{0};
 
-        // 轮询计数器 (mutable 允许在 const 函数中修改)
-        mutable std::atomic<size_t> request_counter_{0};
+        // key -> value，只缓存命中的 GET 结果
+        mutable ShardedLruCache<std::string, std::string> near_cache_;
+        // 失效纪元：每处理一次失效就递增，GET 期间纪元变化说明读到的值可能已过期，不能留在缓存里
+        mutable std::atomic<uint64_t> invalidation_epoch_{0};
     };
 }
\ No newline at end of file
@@ -0,0 +1,141 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#include "redis_cluster.h"
+#include <array>
+#include <charconv>
+#include <boost/redis/resp3/type.hpp>
+
+using namespace user_service::infrastructure;
+
+namespace {
+    // CRC16-CCITT (XMODEM)：多项式 0x1021，初值 0，与 Redis 源码 crc16.c 一致
+    constexpr std::array<uint16_t, 256> MakeCrc16Table() {
+        std::array<uint16_t, 256> table{};
+        for (uint16_t i = 0; i < 256; ++i) {
+            uint16_t crc = i << 8;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+            }
+            table[i] = crc;
+        }
+        return table;
+    }
+    constexpr auto kCrc16Table = MakeCrc16Table();
+
+    uint16_t Crc16(const std::string_view data) {
+        uint16_t crc = 0;
+        for (const char c : data) {
+            crc = static_cast<uint16_t>((crc << 8) ^ kCrc16Table[((crc >> 8) ^ static_cast<uint8_t>(c)) & 0xFF]);
+        }
+        return crc;
+    }
+
+    template<typename T>
+    std::optional<T> ParseNumber(const std::string_view text) {
+        T value{};
+        const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (ec != std::errc() || ptr != text.data() + text.size()) {
+            return std::nullopt;
+        }
+        return value;
+    }
+}
+
+uint16_t user_service::infrastructure::KeyHashSlot(const std::string_view key) {
+    std::string_view hashed = key;
+    if (const auto open = key.find('{'); open != std::string_view::npos) {
+        if (const auto close = key.find('}', open + 1); close != std::string_view::npos && close > open + 1) {
+            hashed = key.substr(open + 1, close - open - 1);
+        }
+    }
+    return Crc16(hashed) & (kClusterSlotCount - 1);
+}
+
+std::optional<std::vector<ClusterSlotRange>> user_service::infrastructure::ParseClusterSlots(
+    const std::vector<boost::redis::resp3::node>& nodes, const std::string& default_host) {
+    using boost::redis::resp3::type;
+    /*
+     * 平铺后的深度：
+     *  0 外层数组
+     *  1 每个槽区间
+     *  2 start, end, 以及每个节点的数组 (第一个是主节点)
+     *  3 节点的 host, port, id, [元数据 map]
+     *  4 元数据内容 (忽略)
+     */
+    if (nodes.empty() || nodes[0].depth != 0 || nodes[0].data_type != type::array) {
+        return std::nullopt;
+    }
+    std::vector<ClusterSlotRange> ranges;
+    ranges.reserve(nodes[0].aggregate_size);
+    size_t i = 1;
+    while (i < nodes.size()) {
+        if (nodes[i].depth != 1 || nodes[i].aggregate_size < 3) {
+            return std::nullopt;
+        }
+        ++i;
+        if (i + 1 >= nodes.size()) {
+            return std::nullopt;
+        }
+        const auto start = ParseNumber<uint16_t>(nodes[i].value);
+        const auto end = ParseNumber<uint16_t>(nodes[i + 1].value);
+        if (!start || !end || *start > *end || *end >= kClusterSlotCount) {
+            return std::nullopt;
+        }
+        i += 2;
+        ClusterSlotRange range{*start, *end, {}, {}};
+        bool has_primary = false;
+        // 该区间的各个节点
+        while (i < nodes.size() && nodes[i].depth == 2) {
+            if (nodes[i].aggregate_size < 2 || i + 2 >= nodes.size() || nodes[i + 1].depth != 3 || nodes[i + 2].depth != 3) {
+                return std::nullopt;
+            }
+            RedisEndpoint endpoint{nodes[i + 1].value, nodes[i + 2].value};
+            if (endpoint.host.empty() || endpoint.host == "?") {
+                endpoint.host = default_host;
+            }
+            if (!has_primary) {
+                range.primary = std::move(endpoint);
+                has_primary = true;
+            } else {
+                range.replicas.push_back(std::move(endpoint));
+            }
+            // 跳过 id 和元数据
+            ++i;
+            while (i < nodes.size() && nodes[i].depth > 2) {
+                ++i;
+            }
+        }
+        if (!has_primary) {
+            return std::nullopt;
+        }
+        ranges.push_back(std::move(range));
+    }
+    return ranges;
+}
+
+std::optional<RedisRedirect> user_service::infrastructure::ParseRedirect(const std::string_view error) {
+    bool ask;
+    std::string_view rest;
+    if (error.starts_with("MOVED ")) {
+        ask = false;
+        rest = error.substr(6);
+    } else if (error.starts_with("ASK ")) {
+        ask = true;
+        rest = error.substr(4);
+    } else {
+        return std::nullopt;
+    }
+    const auto space = rest.find(' ');
+    if (space == std::string_view::npos) {
+        return std::nullopt;
+    }
+    const auto slot = ParseNumber<uint16_t>(rest.substr(0, space));
+    const auto address = rest.substr(space + 1);
+    // IPv6 地址本身带冒号，端口取最后一个冒号之后
+    const auto colon = address.rfind(':');
+    if (!slot || *slot >= kClusterSlotCount || colon == std::string_view::npos || colon == 0) {
+        return std::nullopt;
+    }
+    return RedisRedirect{ask, *slot, RedisEndpoint{std::string(address.substr(0, colon)), std::string(address.substr(colon + 1))}};
+}
@@ -0,0 +1,47 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <boost/redis/resp3/node.hpp>
+
+namespace user_service::infrastructure {
+    // Redis Cluster 固定 16384 个槽
+    constexpr size_t kClusterSlotCount = 16384;
+
+    // key 所在的槽：CRC16 (XMODEM) % 16384；含非空 {hashtag} 时只对花括号内的部分计算，便于把相关 key 放在同一个槽
+    uint16_t KeyHashSlot(std::string_view key);
+
+    struct RedisEndpoint {
+        std::string host;
+        std::string port;
+    };
+
+    // CLUSTER SLOTS 的一项：[start, end] 区间由 primary 负责，replicas 为它的副本
+    struct ClusterSlotRange {
+        uint16_t start;
+        uint16_t end;
+        RedisEndpoint primary;
+        std::vector<RedisEndpoint> replicas;
+    };
+
+    /*
+     * 解析 CLUSTER SLOTS 的平铺回复，格式不符时返回 nullopt
+     * 节点 host 为空 (旧版本) 或 "?" 时表示"与当前连接相同的地址"，用 default_host 代替
+     */
+    std::optional<std::vector<ClusterSlotRange>> ParseClusterSlots(const std::vector<boost::redis::resp3::node>& nodes,
+                                                                   const std::string& default_host);
+
+    // 错误回复 "MOVED <slot> <host>:<port>" / "ASK <slot> <host>:<port>"
+    struct RedisRedirect {
+        bool ask;   // ASK 只对这一条命令生效，MOVED 说明槽已经永久迁移
+        uint16_t slot;
+        RedisEndpoint target;
+    };
+
+    std::optional<RedisRedirect> ParseRedirect(std::string_view error);
+}
@@ -0,0 +1,189 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#include "redis_command_batcher.h"
+#include <spdlog/spdlog.h>
+
+using namespace user_service::infrastructure;
+
+namespace {
+    RedisReply MakeSystemError(std::string message) {
+        return boost::redis::adapter::error{boost::redis::resp3::type::invalid, std::move(message)};
+    }
+
+    // 当前线程是否正在连接的 strand 上执行 (连接由 RedisNode 以 io_context 执行器的 strand 创建)
+    bool RunningInConnectionStrand(const boost::redis::connection& conn) {
+        using Strand = boost::asio::strand<boost::asio::io_context::executor_type>;
+        const auto executor = conn.get_executor();
+        const auto* strand = executor.target<Strand>();
+        return strand != nullptr && strand->running_in_this_thread();
+    }
+
+    // 作为子协程跑在连接的 strand 上；req / resp 位于调用方的协程帧中，调用方等待期间一直有效
+    template<typename Response>
+    boost::asio::awaitable<void> AsyncExecOnStrand(const std::shared_ptr<boost::redis::connection> conn,
+                                                   const boost::redis::request& req, Response& resp, const bool post_first) {
+        if (post_first) {
+            // 子协程的执行器就是 strand，post 完成后仍在 strand 内恢复
+            co_await boost::asio::post(conn->get_executor(), boost::asio::use_awaitable);
+        }
+        co_await conn->async_exec(req, resp, boost::asio::use_awaitable);
+    }
+
+    /*
+     * 在连接的 strand 上发起 async_exec (boost::redis 的连接不是线程安全的)
+     * 不能先 co_await post/dispatch(strand) 再发起：完成会交回调用方协程自己的执行器，调用方与连接不属于同一个
+     * io_context 时 (per-core 模式下借用其他核心的连接、CQ 线程上就地启动、启动阶段跑在 context 0 上、换连接重试)，
+     * 协程恢复时已经不在 strand 内。所以不在 strand 上时，async_exec 作为子协程整体跑在 strand 上，与 PG 连接池的做法相同
+     */
+    template<typename Response>
+    boost::asio::awaitable<void> ExecOnConnection(const std::shared_ptr<boost::redis::connection>& conn,
+                                                  const boost::redis::request& req, Response& resp, const RedisExecMode mode) {
+        if (mode == RedisExecMode::Dispatch && RunningInConnectionStrand(*conn)) {
+            co_await conn->async_exec(req, resp, boost::asio::use_awaitable);
+            co_return;
+        }
+        co_await boost::asio::co_spawn(conn->get_executor(), AsyncExecOnStrand(conn, req, resp, mode == RedisExecMode::Post),
+                                       boost::asio::use_awaitable);
+    }
+}
+
+boost::redis::request user_service::infrastructure::MakeFailFastRequest() {
+    boost::redis::request req;
+    req.get_config().cancel_if_not_connected = true;
+    return req;
+}
+
+boost::asio::awaitable<RedisReply> user_service::infrastructure::ExecRedisCommand(
+    const std::shared_ptr<boost::redis::connection>& conn, const RedisCommand& command, const RedisExecMode mode,
+    const bool fail_fast) {
+    try {
+        boost::redis::request req;
+        req.get_config().cancel_if_not_connected = fail_fast;
+        req.push_range(command.name, command.args);
+
+        boost::redis::response<boost::redis::resp3::node> resp;
+        co_await ExecOnConnection(conn, req, resp, mode);
+
+        co_return std::get<0>(resp);
+    } catch (const std::exception& e) {
+        // 与 redis 断开连接
+        co_return MakeSystemError(fmt::format("{} exception: {}", command.name, e.what()));
+    }
+}
+
+boost::asio::awaitable<boost::redis::generic_response> user_service::infrastructure::ExecRedisRequest(
+    const std::shared_ptr<boost::redis::connection>& conn, const boost::redis::request& req, const RedisExecMode mode) {
+    boost::redis::generic_response resp;
+    try {
+        co_await ExecOnConnection(conn, req, resp, mode);
+    } catch (const std::exception& e) {
+        resp = boost::redis::adapter::error{boost::redis::resp3::type::invalid, fmt::format("exception: {}", e.what())};
+    }
+    co_return resp;
+}
+
+RedisCommandBatcher::RedisCommandBatcher(std::shared_ptr<boost::redis::connection> conn, const size_t max_batch_size):
+    conn_(std::move(conn)), max_batch_size_(std::max<size_t>(max_batch_size, 1)) {
+}
+
+boost::asio::awaitable<RedisReply> RedisCommandBatcher::Exec(RedisCommand command) {
+    const auto executor = co_await boost::asio::this_coro::executor;
+    const auto pending = std::make_shared<PendingCommand>(std::move(command), executor);
+
+    bool schedule = false;
+    {
+        std::lock_guard lock(mutex_);
+        queue_.push_back(pending);
+        if (!flush_scheduled_) {
+            flush_scheduled_ = true;
+            schedule = true;
+        }
+    }
+    if (schedule) {
+        boost::asio::post(conn_->get_executor(), [self = shared_from_this()] { self->Flush(); });
+    }
+
+    boost::system::error_code ec;
+    co_await pending->done.async_receive(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+    co_return std::move(pending->reply);
+}
+
+void RedisCommandBatcher::Flush() {
+    Batch batch;
+    bool more = false;
+    {
+        std::lock_guard lock(mutex_);
+        const size_t n = std::min(queue_.size(), max_batch_size_);
+        batch.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            batch.push_back(std::move(queue_.front()));
+            queue_.pop_front();
+        }
+        // 超过单批上限的部分留给下一次 Flush，flush_scheduled_ 保持为 true
+        more = !queue_.empty();
+        flush_scheduled_ = more;
+    }
+    if (more) {
+        boost::asio::post(conn_->get_executor(), [self = shared_from_this()] { self->Flush(); });
+    }
+    if (!batch.empty()) {
+        SPDLOG_DEBUG("Redis auto-pipeline flush {} commands", batch.size());
+        boost::asio::co_spawn(conn_->get_executor(), ExecBatch(shared_from_this(), std::move(batch)), boost::asio::detached);
+    }
+}
+
+boost::asio::awaitable<void> RedisCommandBatcher::ExecBatch(const std::shared_ptr<RedisCommandBatcher> self, Batch batch) {
+    auto req = MakeFailFastRequest();
+    for (const auto& pending : batch) {
+        req.push_range(pending->command.name, pending->command.args);
+    }
+
+    boost::redis::generic_response resp;
+    try {
+        co_await self->conn_->async_exec(req, resp, boost::asio::use_awaitable);
+    } catch (const std::exception& e) {
+        SPDLOG_ERROR("Redis pipelined batch ({} commands) failed: {}", batch.size(), e.what());
+        for (const auto& pending : batch) {
+            Complete(pending, MakeSystemError(fmt::format("{} exception: {}", pending->command.name, e.what())));
+        }
+        co_return;
+    }
+
+    if (resp.has_error()) {
+        /*
+         * generic_response 遇到错误回复只保留错误本身，分不清是哪条命令的：每条命令单独重放，让调用方拿到自己的结果
+         * (集群中的 MOVED/ASK 也由此落到真正被重定向的那条命令上)。各条同时发出，连接会把它们合并写出，
+         * 只多一次往返，调用方之间也不互相等待。回复依赖执行前状态的命令 (DEL 等) 不走批处理器，重放是安全的
+         */
+        SPDLOG_WARN("Redis pipelined batch got error reply '{}', replaying {} commands individually",
+            resp.error().diagnostic, batch.size());
+        for (const auto& pending : batch) {
+            boost::asio::co_spawn(self->conn_->get_executor(), [self, pending]() -> boost::asio::awaitable<void> {
+                // 已在连接的 strand 上，直接发起
+                Complete(pending, co_await ExecRedisCommand(self->conn_, pending->command, RedisExecMode::Dispatch));
+            }, boost::asio::detached);
+        }
+        co_return;
+    }
+
+    // 每条命令的回复是一个深度为 0 的节点
+    const auto& nodes = resp.value();
+    size_t pos = 0;
+    for (const auto& pending : batch) {
+        while (pos < nodes.size() && nodes[pos].depth != 0) {
+            ++pos;
+        }
+        if (pos < nodes.size()) {
+            Complete(pending, nodes[pos++]);
+        } else {
+            Complete(pending, MakeSystemError(fmt::format("{} reply missing in pipelined batch", pending->command.name)));
+        }
+    }
+}
+
+void RedisCommandBatcher::Complete(const std::shared_ptr<PendingCommand>& pending, RedisReply reply) {
+    pending->reply = std::move(reply);
+    // 容量为 1 且只发送一次，不会失败
+    pending->done.try_send(boost::system::error_code{});
+}
@@ -0,0 +1,98 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#pragma once
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <boost/asio.hpp>
+#include <boost/asio/experimental/concurrent_channel.hpp>
+#include <boost/redis/connection.hpp>
+#include <boost/redis/request.hpp>
+#include <boost/redis/response.hpp>
+
+namespace user_service::infrastructure {
+    /*
+     * 进入连接串行区 (strand) 的方式，两种方式下 async_exec 都在 strand 内发起
+     *  Post：总是以子协程跑在 strand 上，并先投递一次，至少一次队列往返 (对照基线)
+     *  Dispatch：当前已在连接的 strand 上时直接发起 (批处理器重放、探测等)；否则同样以子协程进入 strand，
+     *            子协程以 dispatch 启动，strand 空闲且当前线程正在 run 其底层 io_context 时就地执行，不排队
+     */
+    enum class RedisExecMode {
+        Post,
+        Dispatch
+    };
+
+    // 单条命令，args 不含命令名
+    struct RedisCommand {
+        std::string name;
+        std::vector<std::string> args;
+    };
+
+    // 单条命令的回复；断连等系统级错误同样用 adapter::error 表示，统一交给 RedisClient::ExtractResult 解析
+    using RedisReply = boost::system::result<boost::redis::resp3::node, boost::redis::adapter::error>;
+
+    // 连接级故障 (断连、超时、未连接)；Redis 返回的错误回复不算
+    template<typename Result>
+    bool IsConnectionFailure(const Result& result) {
+        return result.has_error() && result.error().data_type != boost::redis::resp3::type::simple_error &&
+               result.error().data_type != boost::redis::resp3::type::blob_error;
+    }
+
+    // 运行期使用的 request：连接不可用 (重连中) 时立即失败而不是排队等待，由 RedisClient 换一个健康的连接重试
+    boost::redis::request MakeFailFastRequest();
+
+    // 逐条执行：进入连接串行区后单独发送一个 request；fail_fast 为 false 时会一直等到连接建立 (用于启动阶段)
+    boost::asio::awaitable<RedisReply> ExecRedisCommand(const std::shared_ptr<boost::redis::connection>& conn,
+                                                        const RedisCommand& command, RedisExecMode mode,
+                                                        bool fail_fast = true);
+
+    // 执行任意 request (聚合回复、多条命令)，回复平铺为节点序列；断连等系统级错误同样放进 error 中
+    boost::asio::awaitable<boost::redis::generic_response> ExecRedisRequest(const std::shared_ptr<boost::redis::connection>& conn,
+                                                                            const boost::redis::request& req,
+                                                                            RedisExecMode mode);
+
+    /*
+     * 单个连接上的自动流水线
+     * Exec 只在锁内入队，不切换线程；队列由空变非空时向连接的执行器投递一次 Flush，
+     * Flush 执行时 (下一个 tick) 把期间积攒的命令 (最多 max_batch_size 条) 打包成一个 request 发出，
+     * 回复按顺序分发给各个等待中的协程。批次之间互不等待，多个批次可以同时在途
+     *
+     * 只用于回复为单个节点、且重放后回复不变的命令 (GET/SET/PING 等)；批次中出现错误回复时各条命令会被单独重放
+     */
+    class RedisCommandBatcher : public std::enable_shared_from_this<RedisCommandBatcher> {
+    public:
+        RedisCommandBatcher(std::shared_ptr<boost::redis::connection> conn, size_t max_batch_size);
+
+        boost::asio::awaitable<RedisReply> Exec(RedisCommand command);
+
+    private:
+        struct PendingCommand {
+            template<typename Executor>
+            PendingCommand(RedisCommand cmd, const Executor& executor) : command(std::move(cmd)), done(executor, 1) {}
+
+            RedisCommand command;
+            RedisReply reply;
+            // 回复就绪信号，Flush 所在线程与等待方不同，使用线程安全的 channel
+            boost::asio::experimental::concurrent_channel<void(boost::system::error_code)> done;
+        };
+        using Batch = std::vector<std::shared_ptr<PendingCommand>>;
+
+        // 在连接的执行器上运行，取出一批命令交给 ExecBatch
+        void Flush();
+
+        static boost::asio::awaitable<void> ExecBatch(std::shared_ptr<RedisCommandBatcher> self, Batch batch);
+
+        static void Complete(const std::shared_ptr<PendingCommand>& pending, RedisReply reply);
+
+        const std::shared_ptr<boost::redis::connection> conn_;
+        const size_t max_batch_size_;
+
+        std::mutex mutex_;
+        std::deque<std::shared_ptr<PendingCommand>> queue_;
+        // 已投递 Flush 尚未取空队列
+        bool flush_scheduled_ = false;
+    };
+}
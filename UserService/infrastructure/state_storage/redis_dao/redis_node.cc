@@ -0,0 +1,320 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#include "redis_node.h"
+#include "infrastructure/asio_thread_pool/asio_thread_pool.h"
+#include <spdlog/spdlog.h>
+#include <numeric>
+#include <boost/redis/request.hpp>
+#include <boost/redis/resp3/type.hpp>
+
+using namespace user_service::infrastructure;
+
+namespace {
+    // 不健康连接的探测间隔，指数退避
+    constexpr std::chrono::milliseconds kProbeInitialBackoff{100};
+    constexpr std::chrono::milliseconds kProbeMaxBackoff{2000};
+    // 等待新节点首个连接可用时的轮询间隔
+    constexpr std::chrono::milliseconds kInitialReadyPollInterval{10};
+
+    class InFlightGuard {
+    public:
+        explicit InFlightGuard(std::atomic<int64_t>& counter) : counter_(counter) {
+            counter_.fetch_add(1, std::memory_order_relaxed);
+        }
+        ~InFlightGuard() { counter_.fetch_sub(1, std::memory_order_relaxed); }
+        InFlightGuard(const InFlightGuard&) = delete;
+        InFlightGuard& operator=(const InFlightGuard&) = delete;
+    private:
+        std::atomic<int64_t>& counter_;
+    };
+
+    boost::redis::config MakeNodeConfig(boost::redis::config cfg, const bool read_only) {
+        if (read_only) {
+            // 自定义 setup 时不再自动发送 HELLO，需要自己补上
+            if (!cfg.use_setup) {
+                cfg.use_setup = true;
+                cfg.setup.clear();
+                cfg.setup.push("HELLO", "3");
+            }
+            cfg.setup.push("READONLY");
+        }
+        return cfg;
+    }
+}
+
+RedisNode::RedisNode(const std::shared_ptr<AsioThreadPool>& thread_pool, boost::redis::config cfg,
+                     const RedisNodeOptions& options):
+    thread_pool_(thread_pool), cfg_(MakeNodeConfig(std::move(cfg), options.read_only)),
+    name_(fmt::format("{}:{}", cfg_.addr.host, cfg_.addr.port)), exec_mode_(options.exec_mode) {
+    if (options.pool_size <= 0) {
+        throw std::invalid_argument(fmt::format("Invalid Redis pool size: {}. Must be positive.", options.pool_size));
+    }
+    SPDLOG_DEBUG("Execute RedisNode Constructor for {} with pool size: {}", name_, options.pool_size);
+
+    // 日志等级
+    // boost::redis::logger l{boost::redis::logger::level::debug};
+    boost::redis::logger l{boost::redis::logger::level::disabled};
+
+    const int size = options.pool_size;
+    conns_.reserve(size);
+    core_conns_.resize(thread_pool_->Size());
+    for(int i = 0; i < size; ++i) {
+        // 为每个连接绑定独立的 strand，连接轮流分配到各个 io_context 上 (Shared 模式下只有一个)
+        // ExecRedisCommand 据此类型判断是否已在连接的 strand 上，改动时需同步
+        const auto& ioc = thread_pool_->GetIOContext(i);
+        conns_.emplace_back(std::make_shared<boost::redis::connection>(
+            boost::asio::make_strand(ioc->get_executor()), l));
+        core_conns_[i % core_conns_.size()].push_back(i);
+    }
+    conn_states_ = std::make_unique<ConnectionState[]>(conns_.size());
+    all_conns_.resize(conns_.size());
+    std::iota(all_conns_.begin(), all_conns_.end(), 0);
+    // 自动流水线：每个连接一个批处理器
+    if (options.auto_pipeline) {
+        batchers_.reserve(conns_.size());
+        for (const auto& conn : conns_) {
+            batchers_.push_back(std::make_shared<RedisCommandBatcher>(conn, options.pipeline_max_batch));
+        }
+    }
+    // 连接数少于核心数时，没有分到连接的核心借用其他核心的连接；跨核心调用由 ExecRedisCommand 以子协程进入连接的 strand，保证串行
+    for (size_t core = 0; core < core_conns_.size(); ++core) {
+        if (core_conns_[core].empty()) {
+            core_conns_[core].push_back(core % conns_.size());
+        }
+    }
+}
+
+RedisNode::~RedisNode() {
+    for (size_t i = 0; i < conns_.size(); ++i) {
+        const auto& state = conn_states_[i];
+        SPDLOG_INFO("Redis connection {}[{}] stats. Commands: {}, Failures: {}, Recoveries: {}", name_, i,
+            state.commands.load(std::memory_order_relaxed), state.failures.load(std::memory_order_relaxed),
+            state.recoveries.load(std::memory_order_relaxed));
+    }
+}
+
+void RedisNode::Start(RedisPushHandler push_handler) {
+    for (const auto& conn : conns_) {
+        conn->async_run(cfg_, boost::asio::detached);
+    }
+    if (push_handler) {
+        for (const auto& conn : conns_) {
+            boost::asio::co_spawn(conn->get_executor(), ReceivePushes(conn, push_handler), boost::asio::detached);
+        }
+    }
+    // 连接初始均不健康，探测成功后加入轮换；WaitReady 先一步成功时探测直接退出
+    for (size_t i = 0; i < conns_.size(); ++i) {
+        boost::asio::co_spawn(conns_[i]->get_executor(), ProbeUntilHealthy(shared_from_this(), i), boost::asio::detached);
+    }
+    SPDLOG_DEBUG("Redis node {} async_run started", name_);
+}
+
+boost::asio::awaitable<void> RedisNode::WaitReady() {
+    for (size_t i = 0; i < conns_.size(); ++i) {
+        // 直接在指定连接上执行，不经过自动流水线；不 fail-fast，等待连接建立
+        const auto reply = co_await ExecRedisCommand(conns_[i], RedisCommand{"PING", {}}, exec_mode_, false);
+        if (reply.has_error() || reply.value().value != "PONG") {
+            std::string err_msg = fmt::format("Redis node {} init failed at connection [{}]: {}", name_, i,
+                                              reply.has_error() ? reply.error().diagnostic : reply.value().value);
+            SPDLOG_CRITICAL("{}", err_msg);
+            // 启动阶段抛异常
+            throw std::runtime_error(err_msg);
+        }
+        conn_states_[i].healthy.store(true);
+        ready_once_.store(true);
+    }
+    SPDLOG_INFO("Redis node {} (pool size: {}) ready.", name_, conns_.size());
+}
+
+boost::asio::awaitable<bool> RedisNode::WaitInitialReady(const std::chrono::milliseconds timeout) const {
+    // 常见情况：节点早已可用
+    if (ready_once_.load()) {
+        co_return true;
+    }
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    boost::asio::steady_timer timer(co_await boost::asio::this_coro::executor);
+    while (!ready_once_.load()) {
+        // 不等探测的退避：连接建立前 fail-fast 的 PING 立即失败，短间隔轮询，第一个成功的连接直接加入轮换
+        for (size_t i = 0; i < conns_.size(); ++i) {
+            const auto reply = co_await ExecRedisCommand(conns_[i], RedisCommand{"PING", {}}, exec_mode_);
+            if (!IsConnectionFailure(reply)) {
+                conn_states_[i].healthy.store(true);
+                ready_once_.store(true);
+                SPDLOG_INFO("Redis connection {}[{}] in rotation", name_, i);
+                co_return true;
+            }
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            SPDLOG_WARN("Redis node {} not ready within {}ms", name_, timeout.count());
+            co_return false;
+        }
+        timer.expires_after(kInitialReadyPollInterval);
+        co_await timer.async_wait(boost::asio::use_awaitable);
+    }
+    co_return true;
+}
+
+boost::asio::awaitable<RedisReply> RedisNode::Execute(const RedisCommand& command, const bool batchable) const {
+    co_return co_await RunWithFailover<RedisReply>([this, &command, batchable](const size_t idx) {
+        if (batchable && !batchers_.empty()) {
+            // 重试时需要再用一次，这里拷贝
+            return batchers_[idx]->Exec(command);
+        }
+        return ExecRedisCommand(conns_[idx], command, exec_mode_);
+    });
+}
+
+boost::asio::awaitable<boost::redis::generic_response> RedisNode::ExecuteRequest(const boost::redis::request& req) const {
+    co_return co_await RunWithFailover<boost::redis::generic_response>([this, &req](const size_t idx) {
+        return ExecRedisRequest(conns_[idx], req, exec_mode_);
+    });
+}
+
+bool RedisNode::HasHealthyConnection() const {
+    for (size_t i = 0; i < conns_.size(); ++i) {
+        if (conn_states_[i].healthy.load(std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template<typename Result, typename Fn>
+boost::asio::awaitable<Result> RedisNode::RunWithFailover(Fn fn) const {
+    constexpr int kMaxAttempts = 2;
+    for (int attempt = 1; ; ++attempt) {
+        const size_t idx = SelectConnection();
+        auto& state = conn_states_[idx];
+        state.commands.fetch_add(1, std::memory_order_relaxed);
+        Result result;
+        {
+            InFlightGuard guard(state.in_flight);
+            result = co_await fn(idx);
+        }
+        if (!IsConnectionFailure(result)) {
+            co_return result;
+        }
+        MarkUnhealthy(idx);
+        if (attempt >= kMaxAttempts) {
+            co_return result;
+        }
+        SPDLOG_WARN("Redis connection {}[{}] failed: {}, retrying on another connection", name_, idx,
+                    result.error().diagnostic);
+    }
+}
+
+void RedisNode::MarkUnhealthy(const size_t idx) const {
+    auto& state = conn_states_[idx];
+    state.failures.fetch_add(1, std::memory_order_relaxed);
+    // 只有从健康变为不健康的那一次启动探测，保证每个连接同时最多一个探测协程
+    if (state.healthy.exchange(false)) {
+        SPDLOG_WARN("Redis connection {}[{}] removed from rotation", name_, idx);
+        boost::asio::co_spawn(conns_[idx]->get_executor(), ProbeUntilHealthy(shared_from_this(), idx), boost::asio::detached);
+    }
+}
+
+boost::asio::awaitable<void> RedisNode::ProbeUntilHealthy(const std::shared_ptr<const RedisNode> self, const size_t idx) {
+    boost::asio::steady_timer timer(co_await boost::asio::this_coro::executor);
+    auto backoff = kProbeInitialBackoff;
+    for (;;) {
+        timer.expires_after(backoff);
+        co_await timer.async_wait(boost::asio::use_awaitable);
+        auto& state = self->conn_states_[idx];
+        if (state.healthy.load()) {
+            co_return;
+        }
+        // 重连完成前 fail-fast 的 PING 会立即失败
+        const auto reply = co_await ExecRedisCommand(self->conns_[idx], RedisCommand{"PING", {}}, self->exec_mode_);
+        if (!IsConnectionFailure(reply)) {
+            state.recoveries.fetch_add(1, std::memory_order_relaxed);
+            state.healthy.store(true);
+            self->ready_once_.store(true);
+            SPDLOG_INFO("Redis connection {}[{}] in rotation", self->name_, idx);
+            co_return;
+        }
+        backoff = std::min(backoff * 2, kProbeMaxBackoff);
+    }
+}
+
+std::vector<RedisConnectionStats> RedisNode::GetConnectionStats() const {
+    std::vector<RedisConnectionStats> stats;
+    stats.reserve(conns_.size());
+    for (size_t i = 0; i < conns_.size(); ++i) {
+        const auto& state = conn_states_[i];
+        stats.push_back(RedisConnectionStats{
+            name_,
+            state.healthy.load(std::memory_order_relaxed),
+            state.in_flight.load(std::memory_order_relaxed),
+            state.commands.load(std::memory_order_relaxed),
+            state.failures.load(std::memory_order_relaxed),
+            state.recoveries.load(std::memory_order_relaxed)
+        });
+    }
+    return stats;
+}
+
+boost::asio::awaitable<void> RedisNode::ReceivePushes(const std::shared_ptr<boost::redis::connection> conn,
+                                                      const RedisPushHandler handler) {
+    boost::redis::generic_response resp;
+    conn->set_receive_response(resp);
+    for (;;) {
+        boost::system::error_code ec;
+        co_await conn->async_receive(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+        if (ec) {
+            // 只有连接被取消 (关闭) 时才会出错；交给处理函数一个空批次，由它决定如何兜底
+            SPDLOG_WARN("Redis push receiver stopped: {}", ec.message());
+            handler({});
+            co_return;
+        }
+        if (resp.has_value()) {
+            handler(resp.value());
+            resp.value().clear();
+        } else {
+            // 推送解析失败，同样交给处理函数兜底
+            SPDLOG_WARN("Redis push parse error: {}", resp.error().diagnostic);
+            handler({});
+            resp = boost::redis::generic_response{};
+        }
+    }
+}
+
+size_t RedisNode::SelectConnection() const {
+    const size_t counter = request_counter_.fetch_add(1, std::memory_order_relaxed);
+    // per-core 模式下，优先本核心的连接，I/O 完成后无需跨核心唤醒
+    if (thread_pool_->GetModel() == ExecutorModel::PerCore) {
+        if (const auto core = AsioThreadPool::CurrentIndex(); core.has_value()) {
+            if (const auto idx = LeastLoaded(core_conns_[core.value() % core_conns_.size()], counter); idx.has_value()) {
+                SPDLOG_DEBUG("Get the {} redis conn of {} (core {})", idx.value(), name_, core.value());
+                return idx.value();
+            }
+        }
+    }
+    if (const auto idx = LeastLoaded(all_conns_, counter); idx.has_value()) {
+        SPDLOG_DEBUG("Get the {} redis conn of {}", idx.value(), name_);
+        return idx.value();
+    }
+    return counter % conns_.size();
+}
+
+std::optional<size_t> RedisNode::LeastLoaded(const std::vector<size_t>& candidates, const size_t start) const {
+    std::optional<size_t> best;
+    int64_t best_load = 0;
+    for (size_t k = 0; k < candidates.size(); ++k) {
+        const size_t idx = candidates[(start + k) % candidates.size()];
+        const auto& state = conn_states_[idx];
+        if (!state.healthy.load(std::memory_order_relaxed)) {
+            continue;
+        }
+        const int64_t load = state.in_flight.load(std::memory_order_relaxed);
+        if (!best.has_value() || load < best_load) {
+            best = idx;
+            best_load = load;
+            // 空闲连接不可能被超过
+            if (load == 0) {
+                break;
+            }
+        }
+    }
+    return best;
+}
@@ -0,0 +1,127 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <boost/asio.hpp>
+#include <boost/redis/connection.hpp>
+#include <boost/redis/response.hpp>
+#include "infrastructure/state_storage/redis_dao/redis_command_batcher.h"
+
+namespace user_service::infrastructure {
+    class AsioThreadPool;
+
+    // 单个连接的运行状态
+    struct RedisConnectionStats {
+        std::string node;       // host:port
+        bool healthy;
+        int64_t in_flight;      // 已发出未返回的命令数
+        uint64_t commands;      // 累计命令数 (含重试)
+        uint64_t failures;      // 累计连接级失败次数
+        uint64_t recoveries;    // 从不健康恢复的次数 (约等于重连次数)
+    };
+
+    struct RedisNodeOptions {
+        int pool_size;
+        bool auto_pipeline;
+        size_t pipeline_max_batch;
+        RedisExecMode exec_mode;
+        // 集群副本：建连时发送 READONLY，才能在副本上读本分片的 key
+        bool read_only;
+    };
+
+    // 服务端推送 (失效通知等) 的处理函数，在连接的执行器上调用；空批次表示推送流中断或解析失败，应按全部失效处理
+    using RedisPushHandler = std::function<void(const std::vector<boost::redis::resp3::node>&)>;
+
+    /*
+     * 一个 Redis 节点 (host:port) 的连接池
+     * 连接轮流分配到各个 io_context 上；选择在途命令最少的健康连接，连接级失败时移出轮换并后台探测，
+     * 命令换一个健康连接重试一次
+     */
+    class RedisNode : public std::enable_shared_from_this<RedisNode> {
+    public:
+        RedisNode(const std::shared_ptr<AsioThreadPool>& thread_pool, boost::redis::config cfg, const RedisNodeOptions& options);
+        ~RedisNode();
+
+        // 启动所有连接；此时连接都不在轮换中，由后台探测逐个加入。push_handler 非空时持续消费服务端推送
+        void Start(RedisPushHandler push_handler);
+
+        // 启动阶段使用：等待每个连接 PING 成功后加入轮换，失败抛出异常
+        boost::asio::awaitable<void> WaitReady();
+
+        /*
+         * 运行期新建的节点 (重定向目标、拓扑刷新发现的主节点) 使用：连接初始都不在轮换中，命令会快速失败，
+         * 在 timeout 内等到第一个连接可用；曾经可用过的节点直接返回 true，之后的故障交给探测处理。超时返回 false
+         */
+        boost::asio::awaitable<bool> WaitInitialReady(std::chrono::milliseconds timeout) const;
+
+        /*
+         * 单条命令，开启自动流水线且 batchable 时经由所选连接的批处理器
+         * 批次中出现错误回复时批处理器会重放命令，回复依赖执行前状态的命令 (DEL 的删除数等) 须传 batchable = false
+         */
+        boost::asio::awaitable<RedisReply> Execute(const RedisCommand& command, bool batchable = true) const;
+
+        // 任意 request (聚合回复、多条命令)
+        boost::asio::awaitable<boost::redis::generic_response> ExecuteRequest(const boost::redis::request& req) const;
+
+        [[nodiscard]] const std::string& Name() const { return name_; }
+        [[nodiscard]] const std::string& Host() const { return cfg_.addr.host; }
+        [[nodiscard]] bool HasHealthyConnection() const;
+        [[nodiscard]] std::vector<RedisConnectionStats> GetConnectionStats() const;
+
+    private:
+        /*
+         * 选择连接：在候选连接中挑在途命令最少的健康连接，从轮询位置开始扫描，负载相同时等价于 Round-Robin
+         * per-core 模式下优先在当前核心所属的连接中选，都不健康时再看全部连接；全部不健康时退回轮询，命令会快速失败
+         */
+        size_t SelectConnection() const;
+        std::optional<size_t> LeastLoaded(const std::vector<size_t>& candidates, size_t start) const;
+
+        // 在选出的连接上执行 fn(idx)，维护在途计数；连接级失败时把连接移出轮换，并换一个健康连接重试一次
+        template<typename Result, typename Fn>
+        boost::asio::awaitable<Result> RunWithFailover(Fn fn) const;
+
+        // 移出轮换并启动探测，探测成功后重新加入
+        void MarkUnhealthy(size_t idx) const;
+        static boost::asio::awaitable<void> ProbeUntilHealthy(std::shared_ptr<const RedisNode> self, size_t idx);
+
+        // 持续接收一个连接上的服务端推送，开启 tracking 后推送必须被消费，否则连接会阻塞
+        static boost::asio::awaitable<void> ReceivePushes(std::shared_ptr<boost::redis::connection> conn, RedisPushHandler handler);
+
+        const std::shared_ptr<AsioThreadPool> thread_pool_;
+        const boost::redis::config cfg_;
+        const std::string name_;
+        const RedisExecMode exec_mode_;
+
+        std::vector<std::shared_ptr<boost::redis::connection>> conns_;
+        // 每个 io_context 所拥有的连接下标 (core_conns_[i] 中的连接都跑在第 i 个 io_context 上)
+        std::vector<std::vector<size_t>> core_conns_;
+        // 全部连接的下标，作为非 per-core 模式的候选集
+        std::vector<size_t> all_conns_;
+        // 与 conns_ 一一对应，未开启自动流水线时为空
+        std::vector<std::shared_ptr<RedisCommandBatcher>> batchers_;
+
+        // 与 conns_ 一一对应，各占一个缓存行
+        struct alignas(64) ConnectionState {
+            std::atomic<int64_t> in_flight{0};
+            // PING 成功后才加入轮换
+            std::atomic<bool> healthy{false};
+            std::atomic<uint64_t> commands{0};
+            std::atomic<uint64_t> failures{0};
+            std::atomic<uint64_t> recoveries{0};
+        };
+        std::unique_ptr<ConnectionState[]> conn_states_;
+
+        // 曾有连接加入过轮换
+        mutable std::atomic<bool> ready_once_{false};
+
+        // 轮询计数器 (mutable 允许在 const 函数中修改)
+        mutable std::atomic<size_t> request_counter_{0};
+    };
+}
@@ -4,6 +4,7 @@
 #include "server/application.h"
 #include <spdlog/spdlog.h>
 #include <boost/di.hpp>
+#include <filesystem>
 #include <utility>
 #include "server/user_service_server.h"
 
@@ -13,7 +14,10 @@
 #include "infrastructure/asio_thread_pool/asio_thread_pool.h"
 #include "infrastructure/state_storage/redis_dao/redis_client.h"
 #include "infrastructure/persistence/postgresql/include/async_connection_pool.h"
+#include "infrastructure/persistence/postgresql/include/lock_free_connection_pool.h"
+#include "infrastructure/persistence/postgresql/include/pipeline_connection_pool.h"
 #include "infrastructure/persistence/dao/user_dao.h"
+#include "infrastructure/persistence/dao/user_batch_loader.h"
 #include "infrastructure/domain_implement/include/verification_code_repository.h"
 #include "infrastructure/domain_implement/include/user_repository.h"
 
@@ -37,6 +41,20 @@ using namespace user_service::registry;
 
 namespace di = boost::di;
 
+namespace {
+    // 各文件的最后修改时间；读取失败 (文件被删除等) 记为 file_time_type::min()，恢复后同样视为变化
+    std::vector<std::filesystem::file_time_type> GetWriteTimes(const std::vector<std::string>& paths) {
+        std::vector<std::filesystem::file_time_type> times;
+        times.reserve(paths.size());
+        for (const auto& path : paths) {
+            std::error_code ec;
+            const auto time = std::filesystem::last_write_time(path, ec);
+            times.push_back(ec ? std::filesystem::file_time_type::min() : time);
+        }
+        return times;
+    }
+}
+
 Application::Application(std::string&& config_filepath): config_path_(std::move(config_filepath)),
     ioc_(std::make_shared<boost::asio::io_context>()) {
 
@@ -46,9 +64,12 @@ Application::Application(std::string&& config_filepath): config_path_(std::move(
     const auto app_config = AppConfig(config_path_);
     const auto redis_config = app_config.GetRedisConfig();
     const auto db_pool_config = app_config.GetDBPoolConfig();
+    const auto user_batch_config = app_config.GetUserBatchConfig();
+    const auto local_cache_config = app_config.GetLocalCacheConfig();
     const auto jwt_config = app_config.GetJwtConfig();
     const auto server_config = app_config.GetServerConfig();
     const auto rpc_limits_config = app_config.GetRpcLimitsConfig();
+    const auto thread_pool_config = app_config.GetThreadPoolConfig();
     const auto consul_config = app_config.GetConsulConfig();
 
     /*
@@ -61,19 +82,41 @@ Application::Application(std::string&& config_filepath): config_path_(std::move(
     /* ps: ioc一定要传入const指针，否则di内部会创建其他实例 */
     const auto injector = di::make_injector(
         di::bind<boost::asio::io_context>().to(ioc_),
+        di::bind<ThreadPoolConfig>().to(thread_pool_config),
+        di::bind<AsioThreadPool>().in(di::singleton),
         di::bind<DbPoolConfig>().to(db_pool_config),
         di::bind<ServerConfig>().to(server_config),
         di::bind<RpcLimitsConfig>().to(rpc_limits_config),
         di::bind<ConsulConfig>().to(consul_config),
         di::bind<AsyncConnectionPool>().in(di::singleton),
+        di::bind<LockFreeConnectionPool>().in(di::singleton),
+        di::bind<PipelineConnectionPool>().in(di::singleton),
+        // 连接池实现由配置决定，各实现都是单例，这里只负责挑选
+        di::bind<IConnectionPool>().to([db_pool_config](const auto& inj) -> std::shared_ptr<IConnectionPool> {
+            if (db_pool_config.impl == DbPoolImpl::LockFree) {
+                return inj.template create<std::shared_ptr<LockFreeConnectionPool>>();
+            }
+            if (db_pool_config.impl == DbPoolImpl::Pipeline) {
+                return inj.template create<std::shared_ptr<PipelineConnectionPool>>();
+            }
+            return inj.template create<std::shared_ptr<AsyncConnectionPool>>();
+        }),
         di::bind<UserDao>().in(di::singleton),
+        di::bind<UserBatchConfig>().to(user_batch_config),
+        di::bind<UserBatchLoader>().in(di::singleton),
         di::bind<RedisConfig>().to(redis_config),
+        di::bind<LocalCacheConfig>().to(local_cache_config),
+        di::bind<UserLocalCache>().in(di::singleton),
         di::bind<RedisClient>().in(di::singleton),
         di::bind<IVerificationCodeGenerator>().to<CodeGenerator>().in(di::singleton),
         di::bind<IIDGenerator>().to<IdGenerator>().in(di::singleton),
         di::bind<ISecurityUtil>().to<SecurityUtil>().in(di::singleton),
         di::bind<JwtConfig>().to(jwt_config),
-        di::bind<IJwtUtil>().to<JwtUtil>().in(di::singleton),
+        di::bind<JwtUtil>().in(di::singleton),
+        // 热加载密钥需要具体类型，接口与具体类型指向同一个单例
+        di::bind<IJwtUtil>().to([](const auto& inj) -> std::shared_ptr<IJwtUtil> {
+            return inj.template create<std::shared_ptr<JwtUtil>>();
+        }),
         di::bind<IVerificationCodeRepository>().to<VerificationCodeRepository>().in(di::singleton),
         di::bind<IUserRepository>().to<UserRepository>().in(di::singleton),
         di::bind<IAuthService>().to<AuthService>().in(di::singleton),
@@ -82,10 +125,13 @@ Application::Application(std::string&& config_filepath): config_path_(std::move(
     );
     // 获取核心资源（后面需要初始化）
     redis_client_ = injector.create<std::shared_ptr<RedisClient>>();
-    db_pool_ = injector.create<std::shared_ptr<AsyncConnectionPool>>();
-    // 创建 Server 和 ThreadPool
-    thread_pool_ = injector.create<std::unique_ptr<AsioThreadPool>>();
+    db_pool_ = injector.create<std::shared_ptr<IConnectionPool>>();
+    // 创建 Server 和 ThreadPool（ThreadPool 为单例，Redis/DB/Server 共享同一组 io_context）
+    thread_pool_ = injector.create<std::shared_ptr<AsioThreadPool>>();
     server_ = injector.create<std::unique_ptr<UserServiceServer>>();
+    jwt_util_ = injector.create<std::shared_ptr<JwtUtil>>();
+    jwt_keys_reload_interval_ = std::chrono::seconds(jwt_config.keys_reload_seconds);
+    jwt_key_files_ = jwt_config.key_files;
     SPDLOG_INFO("Application constructed.");
 }
 
@@ -132,6 +178,10 @@ void Application::Run() const {
         }, boost::asio::use_future);
         init_future.get();
 
+        if (jwt_keys_reload_interval_.count() > 0) {
+            boost::asio::co_spawn(*ioc_, WatchJwtKeys(), boost::asio::detached);
+        }
+
         // 启动 Server
         SPDLOG_INFO("Application: Starting gRPC Server...");
         server_->Run();
@@ -139,4 +189,37 @@ void Application::Run() const {
         SPDLOG_CRITICAL("Application runtime error: {}", e.what());
         throw;
     }
-}
\ No newline at end of file
+}
+
+boost::asio::awaitable<void> Application::WatchJwtKeys() const {
+    // 被观察的文件：配置文件本身和其中引用的密钥文件 (原地替换 PEM 也要生效)，重新加载后按新配置更新
+    std::vector<std::string> paths{config_path_};
+    paths.insert(paths.end(), jwt_key_files_.begin(), jwt_key_files_.end());
+    auto last_writes = GetWriteTimes(paths);
+    boost::asio::steady_timer timer(co_await boost::asio::this_coro::executor);
+    SPDLOG_INFO("Watching '{}' and {} key files for JWT key changes every {}s", config_path_, jwt_key_files_.size(),
+                jwt_keys_reload_interval_.count());
+    for (;;) {
+        timer.expires_after(jwt_keys_reload_interval_);
+        co_await timer.async_wait(boost::asio::use_awaitable);
+        auto write_times = GetWriteTimes(paths);
+        if (write_times == last_writes) {
+            continue;
+        }
+        last_writes = std::move(write_times);
+        // 文件很小且只在修改后读取一次，直接在 io 线程上同步读取
+        try {
+            const auto jwt_config = AppConfig::LoadJwtConfig(config_path_);
+            jwt_util_->ReloadKeys(jwt_config);
+            // 新配置可能引用了别的密钥文件
+            std::vector<std::string> new_paths{config_path_};
+            new_paths.insert(new_paths.end(), jwt_config.key_files.begin(), jwt_config.key_files.end());
+            if (new_paths != paths) {
+                paths = std::move(new_paths);
+                last_writes = GetWriteTimes(paths);
+            }
+        } catch (const std::exception& e) {
+            SPDLOG_ERROR("JWT key reload failed, keeping current keys: {}", e.what());
+        }
+    }
+}
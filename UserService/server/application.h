@@ -4,12 +4,18 @@
 #pragma once
 #include <string>
 #include <memory>
+#include <chrono>
+#include <vector>
 #include <boost/asio.hpp>
 
+namespace user_service::util {
+    class JwtUtil;
+}
+
 namespace user_service::infrastructure {
     class AsioThreadPool;
     class RedisClient;
-    class AsyncConnectionPool;
+    class IConnectionPool;
 }
 
 namespace user_service::server {
@@ -27,11 +33,18 @@ namespace user_service::server {
         void Run() const;
 
     private:
+        // 按周期检查配置文件及其引用的密钥文件的修改时间，任一变化时重新加载 JWT 密钥；加载失败保留原有密钥
+        boost::asio::awaitable<void> WatchJwtKeys() const;
+
         std::string config_path_;
         const std::shared_ptr<boost::asio::io_context> ioc_;
         std::shared_ptr<infrastructure::RedisClient> redis_client_;
-        std::shared_ptr<infrastructure::AsyncConnectionPool> db_pool_;
-        std::unique_ptr<infrastructure::AsioThreadPool> thread_pool_;
+        std::shared_ptr<infrastructure::IConnectionPool> db_pool_;
+        std::shared_ptr<infrastructure::AsioThreadPool> thread_pool_;
+        std::shared_ptr<util::JwtUtil> jwt_util_;
+        std::chrono::seconds jwt_keys_reload_interval_{0};
+        // 启动时加载的配置所引用的密钥文件
+        std::vector<std::string> jwt_key_files_;
         std::unique_ptr<UserServiceServer> server_;
     };
 }
\ No newline at end of file
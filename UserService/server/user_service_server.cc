@@ -2,7 +2,6 @@
 // Licensed under the MIT License.
 
 #include "user_service_server.h"
-#include <boost/asio/io_context.hpp>
 #include <spdlog/spdlog.h>
 
 #include "adapter/v2/call_data/include/register_call_data.h"
@@ -10,12 +9,17 @@
 #include "adapter/v2/call_data/include/login_by_password_call_data.h"
 #include "adapter/v2/call_data/include/login_by_code_call_data.h"
 #include "adapter/v2/call_data/include/get_user_info_call_data.h"
+#include "adapter/v2/call_data/include/get_jwks_call_data.h"
 
 #include "adapter/v2/call_data_manager/include/register_call_data_manager.h"
 #include "adapter/v2/call_data_manager/include/send_code_call_data_manager.h"
 #include "adapter/v2/call_data_manager/include/login_by_password_call_data_manager.h"
 #include "adapter/v2/call_data_manager/include/login_by_code_call_data_manager.h"
 #include "adapter/v2/call_data_manager/include/get_user_info_call_data_manager.h"
+#include "adapter/v2/call_data_manager/include/get_jwks_call_data_manager.h"
+
+#include "infrastructure/cpu_affinity/cpu_affinity.h"
+#include "infrastructure/asio_thread_pool/asio_thread_pool.h"
 
 using namespace user_service::server;
 using namespace user_service::adapter::v2;
@@ -26,8 +30,8 @@ UserServiceServer::UserServiceServer(const ServerConfig &server_config,
                                      const std::shared_ptr<service::IAuthService> &auth_service,
                                      const std::shared_ptr<service::IBasicUserService> &basic_service,
                                      const std::shared_ptr<util::IJwtUtil> &jwt_util,
-                                     const std::shared_ptr<boost::asio::io_context> &ioc) : server_config_(
-        server_config), rpc_limits_(rpc_limits), registry_(registry), ioc_(ioc),
+                                     const std::shared_ptr<infrastructure::AsioThreadPool> &thread_pool) : server_config_(
+        server_config), rpc_limits_(rpc_limits), registry_(registry), thread_pool_(thread_pool),
     auth_business_service_(auth_service), basic_user_business_service_(basic_service), jwt_util_(jwt_util) {
 }
 
@@ -58,9 +62,9 @@ void UserServiceServer::Shutdown() {
         server_->Shutdown();
     }
 
-    // 关闭 CQ
-    if (cq_) {
-        cq_->Shutdown();
+    // 关闭所有 CQ
+    for (const auto &cq: cqs_) {
+        cq->Shutdown();
     }
 
     if (!worker_threads_.empty()) {
@@ -75,12 +79,14 @@ void UserServiceServer::Shutdown() {
         /* 调试期间：服务发现 consul 未连接成功抛出异常，程序进入析构。
          * 此时导致初始化过程完成一半，也就是 server 起来了，cq 起来了，但是没有初始化监听线程
          * 程序正常析构，cq中包含server->Shutdown产生的事件，需要取出才可析构，否则会抛异常 */
-        if (cq_) {
+        if (!cqs_.empty()) {
             SPDLOG_WARN("Worker threads not started, draining CQ manually...");
             void* tag;
             bool ok;
             // 泄洪操作，把残留事件排空
-            while (cq_->Next(&tag, &ok)) {
+            for (const auto &cq: cqs_) {
+                while (cq->Next(&tag, &ok)) {
+                }
             }
         }
 
@@ -89,12 +95,15 @@ void UserServiceServer::Shutdown() {
     SPDLOG_INFO("UserServiceServer shutdown finished.");
 }
 
-void UserServiceServer::HandleRpc() const {
+void UserServiceServer::HandleRpc(grpc::ServerCompletionQueue* cq, const size_t poller_index) {
     void *tag; // tag 实际上是 ICallData*
     bool ok;
 
+    // 记录线程序号，CallData 据此把协程交给同序号(per-core 模式下即同核心)的 io_context
+    ICallDataManager::BindPollerThread(poller_index);
+
     // 循环：阻塞地从 CQ 中取事件
-    while (cq_->Next(&tag, &ok)) {
+    while (cq->Next(&tag, &ok)) {
         SPDLOG_DEBUG("Get one request");
         static_cast<ICallData *>(tag)->Proceed(ok);
     }
@@ -106,20 +115,46 @@ void UserServiceServer::StartServer() {
     builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
     builder.RegisterService(&auth_grpc_service_);
     builder.RegisterService(&basic_user_grpc_service_);
-    cq_ = builder.AddCompletionQueue();
+    // 分片模式下每个监听线程独占一个 CQ，避免所有线程争抢同一个 CQ 的锁
+    const int cq_count = server_config_.cq_mode == CqMode::Sharded ? server_config_.listen_threads : 1;
+    cqs_.reserve(cq_count);
+    for (int i = 0; i < cq_count; ++i) {
+        cqs_.push_back(builder.AddCompletionQueue());
+    }
     server_ = builder.BuildAndStart();
-    SPDLOG_DEBUG("Server listening on {}", server_address);
+    SPDLOG_DEBUG("Server listening on {} with {} completion queue(s)", server_address, cq_count);
 }
 
 void UserServiceServer::StartListeningThread() {
-    SPDLOG_DEBUG("Starting {} worker threads...", server_config_.worker_threads);
-    worker_threads_.reserve(server_config_.worker_threads);
-    for (int i = 0; i < server_config_.worker_threads; ++i) {
-        worker_threads_.emplace_back(&UserServiceServer::HandleRpc, this);
+    if (server_config_.cq_mode == CqMode::Sharded) {
+        // 一个 CQ 一个线程，并绑定到固定核心
+        SPDLOG_DEBUG("Starting {} pinned polling threads...", cqs_.size());
+        worker_threads_.reserve(cqs_.size());
+        for (size_t i = 0; i < cqs_.size(); ++i) {
+            worker_threads_.emplace_back([cq = cqs_[i].get(), i] {
+                infrastructure::PinCurrentThreadToCpu(static_cast<unsigned>(i));
+                HandleRpc(cq, i);
+            });
+        }
+    } else {
+        SPDLOG_DEBUG("Starting {} worker threads...", server_config_.worker_threads);
+        worker_threads_.reserve(server_config_.worker_threads);
+        for (int i = 0; i < server_config_.worker_threads; ++i) {
+            worker_threads_.emplace_back(&UserServiceServer::HandleRpc, cqs_.front().get(), static_cast<size_t>(i));
+        }
     }
     SPDLOG_DEBUG("Worker threads startup finished");
 }
 
+std::vector<grpc::ServerCompletionQueue *> UserServiceServer::GetCompletionQueues() const {
+    std::vector<grpc::ServerCompletionQueue *> cqs;
+    cqs.reserve(cqs_.size());
+    for (const auto &cq: cqs_) {
+        cqs.push_back(cq.get());
+    }
+    return cqs;
+}
+
 void UserServiceServer::SeedCallData() {
     // 原始播种法
     // (new RegisterCallData(&service_, cq_.get(), *ioc_, basic_service_))->Init();
@@ -127,12 +162,15 @@ void UserServiceServer::SeedCallData() {
 
     /* 模版播种法 */
     SPDLOG_DEBUG("Seeded Template CallData.");
+    // 每个 manager 的 CallData 池会均匀分布到所有 CQ 上
+    const auto cqs = GetCompletionQueues();
+    const auto& iocs = thread_pool_->GetIOContexts();
     // 注册
     register_manager_ = std::make_unique<RegisterCallDataManager>(
         rpc_limits_.register_num,
         &basic_user_grpc_service_,
         basic_user_business_service_.get(),
-        jwt_util_.get(), ioc_, cq_.get());
+        jwt_util_.get(), iocs, cqs);
     register_manager_->Start();
 
     // 发送验证码
@@ -140,28 +178,35 @@ void UserServiceServer::SeedCallData() {
         rpc_limits_.send_code_num,
         &auth_grpc_service_,
         auth_business_service_.get(), jwt_util_.get(),
-        ioc_, cq_.get());
+        iocs, cqs);
     send_code_manager_->Start();
 
     // 密码登录
     login_pw_manager_ = std::make_unique<LoginByPasswordCallDataManager>(
         rpc_limits_.login_pw_num,
         &auth_grpc_service_, auth_business_service_.get(),
-        jwt_util_.get(), ioc_, cq_.get());
+        jwt_util_.get(), iocs, cqs);
     login_pw_manager_->Start();
 
     // 验证码登录
     login_code_manager_ = std::make_unique<LoginByCodeCallDataManager>(
         rpc_limits_.login_code_num,
         &auth_grpc_service_, auth_business_service_.get(),
-        jwt_util_.get(), ioc_, cq_.get());
+        jwt_util_.get(), iocs, cqs);
     login_code_manager_->Start();
 
     // 获取用户信息
     get_user_info_manager_ = std::make_unique<GetUserInfoCallDataManager>(
         rpc_limits_.get_user_info_num,
         &basic_user_grpc_service_,
-        basic_user_business_service_.get(), jwt_util_.get(), ioc_,
-        cq_.get());
+        basic_user_business_service_.get(), jwt_util_.get(), iocs,
+        cqs);
     get_user_info_manager_->Start();
+
+    // JWKS 公钥
+    get_jwks_manager_ = std::make_unique<GetJwksCallDataManager>(
+        rpc_limits_.get_jwks_num,
+        &auth_grpc_service_, auth_business_service_.get(),
+        jwt_util_.get(), iocs, cqs);
+    get_jwks_manager_->Start();
 }
\ No newline at end of file
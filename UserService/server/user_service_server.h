@@ -11,18 +11,28 @@
 #include "service_registry/interface/service_registry.h"
 #include <thread>
 #include <grpcpp/grpcpp.h>
-#include <boost/asio/io_context.hpp>
 
 // 前向声明
+namespace user_service::infrastructure {
+    class AsioThreadPool;
+}
+
 namespace user_service::adapter::v2 {
     class RegisterCallDataManager;
     class SendCodeCallDataManager;
     class LoginByPasswordCallDataManager;
     class LoginByCodeCallDataManager;
     class GetUserInfoCallDataManager;
+    class GetJwksCallDataManager;
 }
 
 namespace user_service::server {
+    // CQ 组织方式
+    enum class CqMode {
+        Single,     // 单个 CQ，worker_threads 个线程共同争抢
+        Sharded     // listen_threads 个 CQ，每个 CQ 由一个绑核线程独占轮询
+    };
+
     // 配置 server
     struct ServerConfig {
         // 部署信息
@@ -30,6 +40,7 @@ namespace user_service::server {
         int port;
         int listen_threads;
         int worker_threads;
+        CqMode cq_mode;
         // 服务注册信息
         registry::RegisterConfig register_info;
     };
@@ -41,6 +52,7 @@ namespace user_service::server {
         int login_pw_num;
         int login_code_num;
         int get_user_info_num;
+        int get_jwks_num;
     };
 
     class UserServiceServer {
@@ -52,7 +64,7 @@ namespace user_service::server {
             const std::shared_ptr<service::IAuthService> &auth_service,
             const std::shared_ptr<service::IBasicUserService> &basic_service,
             const std::shared_ptr<util::IJwtUtil> &jwt_util,
-            const std::shared_ptr<boost::asio::io_context> &ioc);
+            const std::shared_ptr<infrastructure::AsioThreadPool> &thread_pool);
 
         ~UserServiceServer();
 
@@ -61,7 +73,7 @@ namespace user_service::server {
         void Shutdown();
 
     private:
-        void HandleRpc() const;
+        static void HandleRpc(grpc::ServerCompletionQueue* cq, size_t poller_index);
 
         void StartServer();
 
@@ -69,8 +81,10 @@ namespace user_service::server {
 
         void SeedCallData();
 
+        [[nodiscard]] std::vector<grpc::ServerCompletionQueue *> GetCompletionQueues() const;
+
 
-        std::unique_ptr<grpc::ServerCompletionQueue> cq_;
+        std::vector<std::unique_ptr<grpc::ServerCompletionQueue>> cqs_;
         proto::v1::AuthService::AsyncService auth_grpc_service_;
         proto::v1::UserService::AsyncService basic_user_grpc_service_;
         std::unique_ptr<grpc::Server> server_;
@@ -80,13 +94,14 @@ namespace user_service::server {
         std::unique_ptr<adapter::v2::LoginByPasswordCallDataManager> login_pw_manager_{};
         std::unique_ptr<adapter::v2::LoginByCodeCallDataManager> login_code_manager_{};
         std::unique_ptr<adapter::v2::GetUserInfoCallDataManager> get_user_info_manager_{};
+        std::unique_ptr<adapter::v2::GetJwksCallDataManager> get_jwks_manager_{};
 
         std::vector<std::thread> worker_threads_;
 
         ServerConfig server_config_;
         RpcLimitsConfig rpc_limits_;
         const std::shared_ptr<registry::ServiceRegistry> registry_;
-        const std::shared_ptr<boost::asio::io_context> ioc_;
+        const std::shared_ptr<infrastructure::AsioThreadPool> thread_pool_;
         const std::shared_ptr<service::IAuthService> auth_business_service_;
         const std::shared_ptr<service::IBasicUserService> basic_user_business_service_;
         const std::shared_ptr<util::IJwtUtil> jwt_util_;
@@ -0,0 +1,60 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#pragma once
+#include <memory>
+#include <string>
+#include <string_view>
+
+// OpenSSL 类型前向声明，避免头文件依赖扩散
+typedef struct evp_pkey_st EVP_PKEY;
+typedef struct evp_md_ctx_st EVP_MD_CTX;
+
+namespace user_service::util {
+    /*
+     * JWS 非对称密钥：Ed25519 (EdDSA) 或 P-256 (ES256)
+     * 只有公钥时只能校验，公钥参数用于对外发布 JWKS，网关和其他服务拿到后即可本地校验令牌
+     *
+     * 解析密钥、获取算法实现、初始化签名上下文都只在构造时做一次，保存为只读模板；
+     * 每次签名/校验把模板拷贝到本线程复用的工作上下文中，不再重复这些步骤，也不分配新的上下文
+     */
+    class AsymmetricJwtKey {
+    public:
+        enum class Type {
+            Ed25519,
+            EcP256
+        };
+
+        // PEM 可以是私钥 (PKCS#8 / 传统格式) 或公钥 (SubjectPublicKeyInfo)；类型不是 Ed25519 / P-256 时抛出 std::invalid_argument
+        explicit AsymmetricJwtKey(std::string_view pem);
+        ~AsymmetricJwtKey();
+
+        AsymmetricJwtKey(const AsymmetricJwtKey&) = delete;
+        AsymmetricJwtKey& operator=(const AsymmetricJwtKey&) = delete;
+
+        [[nodiscard]] Type GetType() const { return type_; }
+        // JWS alg 名称：EdDSA / ES256
+        [[nodiscard]] std::string_view Alg() const;
+        [[nodiscard]] bool CanSign() const { return sign_template_ != nullptr; }
+
+        // 返回 JWS 格式的签名 (ES256 为 R||S 定长 64 字节，不是 DER)；OpenSSL 内部错误时抛出 std::runtime_error
+        [[nodiscard]] std::string Sign(std::string_view message) const;
+        [[nodiscard]] bool Verify(std::string_view message, std::string_view signature) const;
+
+        // 公钥坐标 (原始字节)，Ed25519 只有 x
+        [[nodiscard]] const std::string& PublicX() const { return public_x_; }
+        [[nodiscard]] const std::string& PublicY() const { return public_y_; }
+
+    private:
+        struct PkeyDeleter { void operator()(EVP_PKEY* pkey) const; };
+        struct MdCtxDeleter { void operator()(EVP_MD_CTX* ctx) const; };
+
+        Type type_;
+        std::unique_ptr<EVP_PKEY, PkeyDeleter> pkey_;
+        // 已完成 DigestSignInit / DigestVerifyInit 的模板，只读，可被多个线程同时拷贝
+        std::unique_ptr<EVP_MD_CTX, MdCtxDeleter> sign_template_;
+        std::unique_ptr<EVP_MD_CTX, MdCtxDeleter> verify_template_;
+        std::string public_x_;
+        std::string public_y_;
+    };
+}
@@ -0,0 +1,38 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <string_view>
+#include <openssl/sha.h>
+
+namespace user_service::util {
+    /*
+     * 预先吸收密钥的 HMAC-SHA256
+     * 构造时把 key^ipad、key^opad 各压缩一个块，保存两份中间状态；之后每条消息只拷贝这两份状态继续计算，
+     * 省去每次派生填充块和两次块压缩。中间状态构造后只读，可被任意线程并发使用，拷贝落在调用方的栈上
+     */
+    class HmacSha256Signer {
+    public:
+        static constexpr size_t kDigestSize = SHA256_DIGEST_LENGTH;
+        using Digest = std::array<unsigned char, kDigestSize>;
+
+        explicit HmacSha256Signer(std::string_view key);
+        ~HmacSha256Signer();
+
+        HmacSha256Signer(const HmacSha256Signer&) = delete;
+        HmacSha256Signer& operator=(const HmacSha256Signer&) = delete;
+
+        // 消息由若干段依次拼接而成，调用方不必先拼成连续内存
+        [[nodiscard]] Digest Sign(std::initializer_list<std::string_view> parts) const;
+
+        // 常量时间比较，mac 长度不对时直接失败
+        [[nodiscard]] bool Verify(std::initializer_list<std::string_view> parts, std::string_view mac) const;
+
+    private:
+        SHA256_CTX inner_;
+        SHA256_CTX outer_;
+    };
+}
@@ -0,0 +1,113 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "utils/interface/i_jwt_util.h"
+#include "utils/include/asymmetric_jwt_key.h"
+#include "utils/include/hmac_sha256_signer.h"
+
+namespace user_service::util {
+    // 校验通过后取出的声明
+    struct JwtClaims {
+        std::string user_id;
+        // 没有 exp 时为 time_point::max()
+        std::chrono::system_clock::time_point expires_at;
+    };
+
+    // 一把轮换密钥，kid 写在令牌 header 中
+    struct JwtKey {
+        std::string kid;
+        // HS256 的共享密钥
+        std::string secret;
+        // HS256 | EdDSA | ES256
+        std::string alg = "HS256";
+        // EdDSA / ES256 的 PEM：私钥可签发可校验，公钥只能校验 (例如其他签发方的密钥)
+        std::string key_pem;
+    };
+
+    /*
+     * 某一时刻有效的全部签名密钥，构造后只读，热加载时整体替换
+     *  - 带 kid 的令牌按 kid 查表 (哈希表，与密钥数量无关)
+     *  - 不带 kid 的令牌 (引入轮换之前签发的) 使用 legacy_secret (HS256)，为空则拒绝
+     *  - 签发使用 active_kid 对应的密钥；active_kid 为空时使用 legacy_secret 且不写 kid
+     * 参数不合法 (kid 重复、密钥为空或无法解析、active_kid 不存在或没有私钥) 时抛出 std::invalid_argument
+     */
+    class JwtKeySet {
+    public:
+        struct Key {
+            // 签名原文为 header_b64 "." payload_b64，签名为原始字节
+            [[nodiscard]] std::string Sign(std::string_view signing_input) const;
+            [[nodiscard]] bool Verify(std::string_view signing_input, std::string_view signature) const;
+            [[nodiscard]] bool CanSign() const { return hmac != nullptr || asymmetric->CanSign(); }
+
+            // 二者恰有一个
+            std::unique_ptr<const HmacSha256Signer> hmac;
+            std::unique_ptr<const AsymmetricJwtKey> asymmetric;
+            // header 中的 alg 必须与之相同，防止以另一种算法冒用同一把密钥
+            std::string alg;
+            // 签发时使用的 header，编码结果预先算好
+            std::string header_b64;
+        };
+
+        JwtKeySet(std::string_view legacy_secret, const std::vector<JwtKey>& keys, std::string active_kid);
+
+        // kid 为空表示令牌不带 kid；未知 kid 返回 nullptr
+        [[nodiscard]] const Key* Find(std::string_view kid) const;
+
+        [[nodiscard]] const Key& Signing() const { return *signing_; }
+        [[nodiscard]] const std::string& ActiveKid() const { return active_kid_; }
+        [[nodiscard]] size_t Size() const { return keys_.size(); }
+        // 非对称密钥的公钥集合 (RFC 7517 JWK Set)，HS256 密钥不会出现在其中
+        [[nodiscard]] const std::string& Jwks() const { return jwks_; }
+
+    private:
+        // 支持以 string_view 查找，校验时不构造 std::string
+        struct KidHash {
+            using is_transparent = void;
+            size_t operator()(const std::string_view kid) const { return std::hash<std::string_view>{}(kid); }
+        };
+
+        std::unordered_map<std::string, Key, KidHash, std::equal_to<>> keys_;
+        std::unique_ptr<Key> legacy_;
+        const std::string active_kid_;
+        const Key* signing_ = nullptr;
+        std::string jwks_;
+    };
+
+    /*
+     * 专用的 JWT 编解码 (HS256 / EdDSA / ES256)，只处理本服务签发的令牌格式：
+     *  header  {"alg":"..","kid":"..","typ":"JWS"}  (kid 可无)
+     *  payload {"exp":..,"iat":..,"iss":"..","user_id":".."}
+     * 校验全程在 string_view 上进行：base64url 解码到栈上缓冲区，签名直接对原文计算，
+     * 只扫描 alg / kid / iss / exp / user_id，除返回的 user_id 外不分配内存
+     */
+    class JwtCodec {
+    public:
+        JwtCodec(std::shared_ptr<const JwtKeySet> keys, std::string issuer);
+
+        // 签名失败 (仅 OpenSSL 内部错误) 时抛出 std::runtime_error
+        [[nodiscard]] std::string Sign(std::string_view user_id, std::chrono::system_clock::time_point issued_at,
+                                       std::chrono::system_clock::time_point expires_at) const;
+
+        // 依次检查：结构、alg/kid、签名、iss、exp、user_id
+        [[nodiscard]] std::expected<JwtClaims, JwtError> Verify(std::string_view token) const;
+
+        // 替换密钥集合，之后签发与校验立即使用新集合；进行中的调用仍持有旧快照，不受影响
+        void ReplaceKeys(std::shared_ptr<const JwtKeySet> keys);
+
+        [[nodiscard]] std::shared_ptr<const JwtKeySet> Keys() const { return keys_.load(); }
+
+    private:
+        std::atomic<std::shared_ptr<const JwtKeySet>> keys_;
+        const std::string issuer_;
+    };
+}
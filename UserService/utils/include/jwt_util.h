@@ -2,18 +2,32 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
 #include "utils/interface/i_jwt_util.h"
+#include "utils/include/jwt_codec.h"
+#include "infrastructure/local_cache/sharded_lru_cache.h"
 
 namespace user_service::util {
     struct JwtConfig {
+        // 校验不带 kid 的令牌 (引入密钥轮换前签发的)；active_kid 为空时也用它签发
         std::string secret_key;
         std::string issuer;
         int expiration_seconds;
+        // 校验结果缓存：同一个 token 会被客户端反复使用数小时，命中后跳过解码、JSON 解析和 HMAC
+        infrastructure::LocalCacheConfig verify_cache;
+        // 轮换密钥：新令牌用 active_kid 签发，keys 中的其余密钥只用于校验，旧令牌自然过期后再移除
+        std::vector<JwtKey> keys;
+        std::string active_kid;
+        // keys 中非对称密钥读取自的文件，热加载时与配置文件一同检查修改时间
+        std::vector<std::string> key_files;
+        // 检查配置文件变化并重新加载密钥的周期，0 表示不热加载
+        int keys_reload_seconds = 0;
     };
 
     class JwtUtil: public IJwtUtil {
-        static constexpr auto CLAIM_USER_ID = "user_id";
-        static constexpr auto TOKEN_TYPE = "JWS";
     public:
         explicit JwtUtil(const JwtConfig& config);
         ~JwtUtil() override;
@@ -21,10 +35,39 @@ namespace user_service::util {
         std::string GenerateToken(const std::string& user_id) override;
         std::expected<std::string, JwtError> VerifyToken(const std::string& token) override;
         std::expected<std::string, JwtError> VerifyToken(std::string_view token) override;
+        std::string GetJwks() override;
+
+        /*
+         * 替换密钥集合，只使用 config 中的 secret_key / keys / active_kid，其余字段不可热更新
+         * 密钥不合法时抛出 std::invalid_argument，原有密钥保持不变
+         */
+        void ReloadKeys(const JwtConfig& config);
+
+        [[nodiscard]] infrastructure::LocalCacheStats GetVerifyCacheStats() const { return verify_cache_.GetStats(); }
 
     private:
-        const std::string secret_key_;
+        // 校验通过的 token；保存完整 token，命中时逐字节比对，哈希碰撞不会把别人的 token 当成有效
+        struct VerifiedToken {
+            std::string token;
+            std::string user_id;
+            std::chrono::system_clock::time_point expires_at;
+            // 校验时的密钥代数，密钥集合替换后旧条目不再命中，被移除的密钥签发的令牌随之失效
+            uint64_t key_generation;
+        };
+
+        // 完整校验，成功时返回的 VerifiedToken 可直接放入缓存
+        std::expected<std::shared_ptr<const VerifiedToken>, JwtError> VerifyTokenUncached(std::string_view token,
+                                                                                        uint64_t key_generation) const;
+
+        static std::shared_ptr<const JwtKeySet> MakeKeySet(const JwtConfig& config);
+
         const std::string issuer_;
         const std::chrono::seconds expiration_seconds_;
+        // 签发与校验都走专用实现，HS256 令牌格式与此前 jwt-cpp 签发的一致，已签发的令牌继续有效
+        JwtCodec codec_;
+        std::atomic<uint64_t> key_generation_{0};
+
+        // token 的 64 位哈希 -> 校验结果，条目共享只读，命中时不拷贝 token
+        infrastructure::ShardedLruCache<uint64_t, std::shared_ptr<const VerifiedToken>> verify_cache_;
     };
-}
\ No newline at end of file
+}
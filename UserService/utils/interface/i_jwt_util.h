@@ -25,5 +25,8 @@ namespace user_service::util {
         virtual std::expected<std::string, JwtError> VerifyToken(const std::string& token) = 0;
         // 预留高性能验证接口
         virtual std::expected<std::string, JwtError> VerifyToken(std::string_view token) = 0;
+
+        // 公钥集合 (JWKS JSON)，供其他服务和网关本地校验非对称签名的令牌；没有非对称密钥时为 {"keys":[]}
+        virtual std::string GetJwks() = 0;
     };
 }
\ No newline at end of file
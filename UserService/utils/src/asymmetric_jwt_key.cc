@@ -0,0 +1,172 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#include "utils/include/asymmetric_jwt_key.h"
+#include <openssl/bio.h>
+#include <openssl/bn.h>
+#include <openssl/core_names.h>
+#include <openssl/ec.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <cstring>
+#include <stdexcept>
+
+using namespace user_service::util;
+
+namespace {
+    // P-256 坐标与 R/S 的字节长度
+    constexpr size_t kP256FieldSize = 32;
+
+    // 本线程复用的工作上下文，拷贝模板时会先清空，不同密钥之间可以共用
+    EVP_MD_CTX* ThreadWorkContext() {
+        thread_local const std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> ctx(EVP_MD_CTX_new(), &EVP_MD_CTX_free);
+        return ctx.get();
+    }
+
+    EVP_PKEY* ReadPem(const std::string_view pem, bool& is_private) {
+        const std::unique_ptr<BIO, decltype(&BIO_free)> bio(BIO_new_mem_buf(pem.data(), static_cast<int>(pem.size())), &BIO_free);
+        if (!bio) {
+            return nullptr;
+        }
+        if (EVP_PKEY* pkey = PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr, nullptr)) {
+            is_private = true;
+            return pkey;
+        }
+        BIO_reset(bio.get());
+        is_private = false;
+        return PEM_read_bio_PUBKEY(bio.get(), nullptr, nullptr, nullptr);
+    }
+
+    std::string BignumParam(const EVP_PKEY* pkey, const char* name) {
+        BIGNUM* bn = nullptr;
+        if (EVP_PKEY_get_bn_param(pkey, name, &bn) != 1) {
+            throw std::invalid_argument("Failed to read EC public key coordinate");
+        }
+        std::string out(kP256FieldSize, '\0');
+        const int written = BN_bn2binpad(bn, reinterpret_cast<unsigned char*>(out.data()), kP256FieldSize);
+        BN_free(bn);
+        if (written != static_cast<int>(kP256FieldSize)) {
+            throw std::invalid_argument("Invalid EC public key coordinate");
+        }
+        return out;
+    }
+}
+
+void AsymmetricJwtKey::PkeyDeleter::operator()(EVP_PKEY* pkey) const {
+    EVP_PKEY_free(pkey);
+}
+
+void AsymmetricJwtKey::MdCtxDeleter::operator()(EVP_MD_CTX* ctx) const {
+    EVP_MD_CTX_free(ctx);
+}
+
+AsymmetricJwtKey::AsymmetricJwtKey(const std::string_view pem) {
+    bool is_private = false;
+    pkey_.reset(ReadPem(pem, is_private));
+    if (!pkey_) {
+        throw std::invalid_argument("Failed to parse PEM key");
+    }
+
+    if (EVP_PKEY_is_a(pkey_.get(), "ED25519")) {
+        type_ = Type::Ed25519;
+        public_x_.resize(32);
+        size_t len = public_x_.size();
+        if (EVP_PKEY_get_raw_public_key(pkey_.get(), reinterpret_cast<unsigned char*>(public_x_.data()), &len) != 1 ||
+            len != 32) {
+            throw std::invalid_argument("Failed to read Ed25519 public key");
+        }
+    } else if (EVP_PKEY_is_a(pkey_.get(), "EC")) {
+        char group[32] = {};
+        if (EVP_PKEY_get_group_name(pkey_.get(), group, sizeof(group), nullptr) != 1 ||
+            std::strcmp(group, SN_X9_62_prime256v1) != 0) {
+            throw std::invalid_argument("Only P-256 EC keys are supported for ES256");
+        }
+        type_ = Type::EcP256;
+        public_x_ = BignumParam(pkey_.get(), OSSL_PKEY_PARAM_EC_PUB_X);
+        public_y_ = BignumParam(pkey_.get(), OSSL_PKEY_PARAM_EC_PUB_Y);
+    } else {
+        throw std::invalid_argument("Unsupported key type, expected Ed25519 or P-256");
+    }
+
+    // Ed25519 不接受外部摘要算法
+    const EVP_MD* md = type_ == Type::EcP256 ? EVP_sha256() : nullptr;
+    verify_template_.reset(EVP_MD_CTX_new());
+    if (!verify_template_ || EVP_DigestVerifyInit(verify_template_.get(), nullptr, md, nullptr, pkey_.get()) != 1) {
+        throw std::invalid_argument("Failed to initialize verify context");
+    }
+    if (is_private) {
+        sign_template_.reset(EVP_MD_CTX_new());
+        if (!sign_template_ || EVP_DigestSignInit(sign_template_.get(), nullptr, md, nullptr, pkey_.get()) != 1) {
+            throw std::invalid_argument("Failed to initialize sign context");
+        }
+    }
+}
+
+AsymmetricJwtKey::~AsymmetricJwtKey() = default;
+
+std::string_view AsymmetricJwtKey::Alg() const {
+    return type_ == Type::Ed25519 ? "EdDSA" : "ES256";
+}
+
+std::string AsymmetricJwtKey::Sign(const std::string_view message) const {
+    if (!CanSign()) {
+        throw std::runtime_error("JWT key has no private part");
+    }
+    EVP_MD_CTX* ctx = ThreadWorkContext();
+    unsigned char signature[80];
+    size_t signature_len = sizeof(signature);
+    if (EVP_MD_CTX_copy_ex(ctx, sign_template_.get()) != 1 ||
+        EVP_DigestSign(ctx, signature, &signature_len, reinterpret_cast<const unsigned char*>(message.data()), message.size()) != 1) {
+        throw std::runtime_error("JWT signing failed");
+    }
+    if (type_ == Type::Ed25519) {
+        return {reinterpret_cast<const char*>(signature), signature_len};
+    }
+
+    // OpenSSL 输出 DER 编码的 ECDSA 签名，JWS 要求定长 R||S
+    const unsigned char* der = signature;
+    const std::unique_ptr<ECDSA_SIG, decltype(&ECDSA_SIG_free)> sig(
+        d2i_ECDSA_SIG(nullptr, &der, static_cast<long>(signature_len)), &ECDSA_SIG_free);
+    std::string raw(2 * kP256FieldSize, '\0');
+    auto* out = reinterpret_cast<unsigned char*>(raw.data());
+    if (!sig || BN_bn2binpad(ECDSA_SIG_get0_r(sig.get()), out, kP256FieldSize) < 0 ||
+        BN_bn2binpad(ECDSA_SIG_get0_s(sig.get()), out + kP256FieldSize, kP256FieldSize) < 0) {
+        throw std::runtime_error("JWT signing failed: invalid ECDSA signature");
+    }
+    return raw;
+}
+
+bool AsymmetricJwtKey::Verify(const std::string_view message, const std::string_view signature) const {
+    const auto* data = reinterpret_cast<const unsigned char*>(signature.data());
+    size_t len = signature.size();
+    unsigned char der[80];
+    if (type_ == Type::Ed25519) {
+        if (len != 64) {
+            return false;
+        }
+    } else {
+        // R||S 转回 DER 交给 OpenSSL
+        if (len != 2 * kP256FieldSize) {
+            return false;
+        }
+        const std::unique_ptr<ECDSA_SIG, decltype(&ECDSA_SIG_free)> sig(ECDSA_SIG_new(), &ECDSA_SIG_free);
+        BIGNUM* r = BN_bin2bn(data, kP256FieldSize, nullptr);
+        BIGNUM* s = BN_bin2bn(data + kP256FieldSize, kP256FieldSize, nullptr);
+        if (!sig || !r || !s || ECDSA_SIG_set0(sig.get(), r, s) != 1) {
+            BN_free(r);
+            BN_free(s);
+            return false;
+        }
+        unsigned char* out = der;
+        const int der_len = i2d_ECDSA_SIG(sig.get(), &out);
+        if (der_len <= 0) {
+            return false;
+        }
+        data = der;
+        len = static_cast<size_t>(der_len);
+    }
+
+    EVP_MD_CTX* ctx = ThreadWorkContext();
+    return EVP_MD_CTX_copy_ex(ctx, verify_template_.get()) == 1 &&
+           EVP_DigestVerify(ctx, data, len, reinterpret_cast<const unsigned char*>(message.data()), message.size()) == 1;
+}
@@ -0,0 +1,61 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+// 需要能按值拷贝的哈希中间状态，EVP_MAC 不提供，只能用 OpenSSL 3 中已标记废弃的 SHA256_* 底层接口
+#define OPENSSL_SUPPRESS_DEPRECATED
+#include "utils/include/hmac_sha256_signer.h"
+#include <cstring>
+#include <openssl/crypto.h>
+
+using namespace user_service::util;
+
+HmacSha256Signer::HmacSha256Signer(const std::string_view key) {
+    // RFC 2104：密钥超过块长时先哈希
+    constexpr size_t kBlockSize = SHA256_CBLOCK;
+    unsigned char key_block[kBlockSize] = {};
+    if (key.size() > kBlockSize) {
+        SHA256(reinterpret_cast<const unsigned char*>(key.data()), key.size(), key_block);
+    } else {
+        std::memcpy(key_block, key.data(), key.size());
+    }
+
+    unsigned char pad[kBlockSize];
+    for (size_t i = 0; i < kBlockSize; ++i) pad[i] = key_block[i] ^ 0x36;
+    SHA256_Init(&inner_);
+    SHA256_Update(&inner_, pad, kBlockSize);
+
+    for (size_t i = 0; i < kBlockSize; ++i) pad[i] = key_block[i] ^ 0x5c;
+    SHA256_Init(&outer_);
+    SHA256_Update(&outer_, pad, kBlockSize);
+
+    OPENSSL_cleanse(key_block, sizeof(key_block));
+    OPENSSL_cleanse(pad, sizeof(pad));
+}
+
+HmacSha256Signer::~HmacSha256Signer() {
+    OPENSSL_cleanse(&inner_, sizeof(inner_));
+    OPENSSL_cleanse(&outer_, sizeof(outer_));
+}
+
+HmacSha256Signer::Digest HmacSha256Signer::Sign(const std::initializer_list<std::string_view> parts) const {
+    SHA256_CTX ctx = inner_;
+    for (const auto part : parts) {
+        SHA256_Update(&ctx, part.data(), part.size());
+    }
+    unsigned char inner_digest[kDigestSize];
+    SHA256_Final(inner_digest, &ctx);
+
+    ctx = outer_;
+    SHA256_Update(&ctx, inner_digest, kDigestSize);
+    Digest digest;
+    SHA256_Final(digest.data(), &ctx);
+    return digest;
+}
+
+bool HmacSha256Signer::Verify(const std::initializer_list<std::string_view> parts, const std::string_view mac) const {
+    if (mac.size() != kDigestSize) {
+        return false;
+    }
+    const auto expected = Sign(parts);
+    return CRYPTO_memcmp(expected.data(), mac.data(), kDigestSize) == 0;
+}
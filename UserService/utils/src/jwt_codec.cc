@@ -0,0 +1,486 @@
+// Copyright (c) 2025 seaStarLxy.
+// Licensed under the MIT License.
+
+#include "utils/include/jwt_codec.h"
+#include <array>
+#include <charconv>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+using namespace user_service::util;
+
+namespace {
+    // 解码缓冲区上限，超过视为非法令牌
+    constexpr size_t kMaxHeaderBytes = 256;
+    constexpr size_t kMaxPayloadBytes = 1024;
+    // 签名原始字节上限 (HS256 / EdDSA 为 32 / 64，ES256 的 R||S 为 64)
+    constexpr size_t kMaxSignatureBytes = 64;
+
+    constexpr char kBase64UrlAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+    constexpr std::array<int8_t, 256> MakeBase64UrlTable() {
+        std::array<int8_t, 256> table{};
+        table.fill(-1);
+        for (int i = 0; i < 64; ++i) {
+            table[static_cast<unsigned char>(kBase64UrlAlphabet[i])] = static_cast<int8_t>(i);
+        }
+        return table;
+    }
+    constexpr auto kBase64UrlTable = MakeBase64UrlTable();
+
+    void Base64UrlEncode(const std::string_view in, std::string& out) {
+        size_t i = 0;
+        for (; i + 3 <= in.size(); i += 3) {
+            const uint32_t n = static_cast<uint8_t>(in[i]) << 16 | static_cast<uint8_t>(in[i + 1]) << 8 |
+                               static_cast<uint8_t>(in[i + 2]);
+            out.push_back(kBase64UrlAlphabet[n >> 18 & 63]);
+            out.push_back(kBase64UrlAlphabet[n >> 12 & 63]);
+            out.push_back(kBase64UrlAlphabet[n >> 6 & 63]);
+            out.push_back(kBase64UrlAlphabet[n & 63]);
+        }
+        // 无填充
+        if (const size_t rest = in.size() - i; rest > 0) {
+            uint32_t n = static_cast<uint8_t>(in[i]) << 16;
+            if (rest == 2) {
+                n |= static_cast<uint8_t>(in[i + 1]) << 8;
+            }
+            out.push_back(kBase64UrlAlphabet[n >> 18 & 63]);
+            out.push_back(kBase64UrlAlphabet[n >> 12 & 63]);
+            if (rest == 2) {
+                out.push_back(kBase64UrlAlphabet[n >> 6 & 63]);
+            }
+        }
+    }
+
+    // 解码到调用方的缓冲区，返回写入的字节数；非法字符、非法长度或缓冲区不足时返回 nullopt
+    std::optional<size_t> Base64UrlDecode(const std::string_view in, char* out, const size_t capacity) {
+        // 无填充时每 4 个字符对应 3 字节，余 1 个字符不可能出现
+        if (in.size() % 4 == 1 || in.size() * 6 / 8 > capacity) {
+            return std::nullopt;
+        }
+        size_t len = 0;
+        uint32_t acc = 0;
+        int bits = 0;
+        for (const char c : in) {
+            const int8_t v = kBase64UrlTable[static_cast<unsigned char>(c)];
+            if (v < 0) {
+                return std::nullopt;
+            }
+            acc = acc << 6 | static_cast<uint32_t>(v);
+            bits += 6;
+            if (bits >= 8) {
+                bits -= 8;
+                out[len++] = static_cast<char>(acc >> bits & 0xFF);
+            }
+        }
+        // 末尾多出的位必须为 0，拒绝同一内容的多种编码
+        if ((acc & ((1u << bits) - 1)) != 0) {
+            return std::nullopt;
+        }
+        return len;
+    }
+
+    void AppendJsonString(std::string& out, const std::string_view value) {
+        out.push_back('"');
+        for (const char c : value) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        constexpr char kHex[] = "0123456789abcdef";
+                        out += "\\u00";
+                        out.push_back(kHex[c >> 4]);
+                        out.push_back(kHex[c & 0xF]);
+                    } else {
+                        out.push_back(c);
+                    }
+            }
+        }
+        out.push_back('"');
+    }
+
+    /*
+     * 最小 JSON 扫描器：只认顶层对象，逐个读取 key，感兴趣的值交给回调，其余的值跳过 (包括嵌套结构)
+     * 字符串值只做最常见的转义还原；\u 仅支持 ASCII 范围，足够覆盖本服务签发的令牌
+     */
+    class JsonScanner {
+    public:
+        explicit JsonScanner(const std::string_view text) : text_(text) {}
+
+        template<typename OnField>
+        bool ScanObject(OnField&& on_field) {
+            SkipSpace();
+            if (!Consume('{')) return false;
+            SkipSpace();
+            if (Consume('}')) return AtEnd();
+            for (;;) {
+                std::string key;
+                SkipSpace();
+                if (!ReadString(key)) return false;
+                SkipSpace();
+                if (!Consume(':')) return false;
+                SkipSpace();
+                if (!on_field(key, *this)) return false;
+                SkipSpace();
+                if (Consume(',')) continue;
+                if (Consume('}')) return AtEnd();
+                return false;
+            }
+        }
+
+        // 读出的值覆盖 out 原有内容
+        bool ReadString(std::string& out) {
+            out.clear();
+            if (!Consume('"')) return false;
+            while (pos_ < text_.size()) {
+                const char c = text_[pos_++];
+                if (c == '"') return true;
+                if (c != '\\') {
+                    out.push_back(c);
+                    continue;
+                }
+                if (pos_ >= text_.size()) return false;
+                switch (text_[pos_++]) {
+                    case '"': out.push_back('"'); break;
+                    case '\\': out.push_back('\\'); break;
+                    case '/': out.push_back('/'); break;
+                    case 'b': out.push_back('\b'); break;
+                    case 'f': out.push_back('\f'); break;
+                    case 'n': out.push_back('\n'); break;
+                    case 'r': out.push_back('\r'); break;
+                    case 't': out.push_back('\t'); break;
+                    case 'u': {
+                        unsigned code = 0;
+                        if (pos_ + 4 > text_.size()) return false;
+                        const auto [ptr, ec] = std::from_chars(text_.data() + pos_, text_.data() + pos_ + 4, code, 16);
+                        if (ec != std::errc() || ptr != text_.data() + pos_ + 4 || code > 0x7F) return false;
+                        pos_ += 4;
+                        out.push_back(static_cast<char>(code));
+                        break;
+                    }
+                    default: return false;
+                }
+            }
+            return false;
+        }
+
+        // NumericDate：允许小数，只取整数部分
+        bool ReadInt64(int64_t& out) {
+            const auto [ptr, ec] = std::from_chars(text_.data() + pos_, text_.data() + text_.size(), out);
+            if (ec != std::errc()) return false;
+            pos_ = ptr - text_.data();
+            if (pos_ < text_.size() && text_[pos_] == '.') {
+                ++pos_;
+                while (pos_ < text_.size() && text_[pos_] >= '0' && text_[pos_] <= '9') ++pos_;
+            }
+            return true;
+        }
+
+        bool SkipValue() {
+            if (pos_ >= text_.size()) return false;
+            if (text_[pos_] == '"') {
+                std::string ignored;
+                return ReadString(ignored);
+            }
+            // 嵌套对象/数组按括号深度跳过，留意字符串中的括号
+            int depth = 0;
+            while (pos_ < text_.size()) {
+                const char c = text_[pos_];
+                if (c == '"') {
+                    std::string ignored;
+                    if (!ReadString(ignored)) return false;
+                    continue;
+                }
+                if (c == '{' || c == '[') {
+                    ++depth;
+                } else if (c == '}' || c == ']') {
+                    if (depth == 0) return true;
+                    --depth;
+                } else if (c == ',' && depth == 0) {
+                    return true;
+                }
+                ++pos_;
+            }
+            return depth == 0;
+        }
+
+    private:
+        void SkipSpace() {
+            while (pos_ < text_.size() && (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\n' || text_[pos_] == '\r')) {
+                ++pos_;
+            }
+        }
+        bool Consume(const char c) {
+            if (pos_ < text_.size() && text_[pos_] == c) {
+                ++pos_;
+                return true;
+            }
+            return false;
+        }
+        bool AtEnd() {
+            SkipSpace();
+            return pos_ == text_.size();
+        }
+
+        const std::string_view text_;
+        size_t pos_ = 0;
+    };
+
+    int64_t ToNumericDate(const std::chrono::system_clock::time_point tp) {
+        return std::chrono::duration_cast<std::chrono::seconds>(tp.time_since_epoch()).count();
+    }
+
+    // {"alg":"..","kid":"..","typ":"JWS"}，key 按字典序，kid 为空时省略
+    std::string MakeHeaderB64(const std::string_view alg, const std::string_view kid) {
+        std::string header = "{\"alg\":";
+        AppendJsonString(header, alg);
+        header.push_back(',');
+        if (!kid.empty()) {
+            header += "\"kid\":";
+            AppendJsonString(header, kid);
+            header.push_back(',');
+        }
+        header += "\"typ\":\"JWS\"}";
+        std::string encoded;
+        Base64UrlEncode(header, encoded);
+        return encoded;
+    }
+
+    // 单个公钥的 JWK
+    void AppendJwk(std::string& out, const std::string_view kid, const AsymmetricJwtKey& key) {
+        if (key.GetType() == AsymmetricJwtKey::Type::Ed25519) {
+            out += "{\"kty\":\"OKP\",\"crv\":\"Ed25519\",\"x\":\"";
+            Base64UrlEncode(key.PublicX(), out);
+        } else {
+            out += "{\"kty\":\"EC\",\"crv\":\"P-256\",\"x\":\"";
+            Base64UrlEncode(key.PublicX(), out);
+            out += "\",\"y\":\"";
+            Base64UrlEncode(key.PublicY(), out);
+        }
+        out += "\",\"use\":\"sig\",\"alg\":";
+        AppendJsonString(out, key.Alg());
+        out += ",\"kid\":";
+        AppendJsonString(out, kid);
+        out.push_back('}');
+    }
+
+    JwtKeySet::Key MakeKey(const JwtKey& config) {
+        JwtKeySet::Key key;
+        if (config.alg == "HS256") {
+            if (config.secret.empty()) {
+                throw std::invalid_argument(fmt::format("JWT key '{}' has an empty secret", config.kid));
+            }
+            key.hmac = std::make_unique<const HmacSha256Signer>(config.secret);
+        } else if (config.alg == "EdDSA" || config.alg == "ES256") {
+            try {
+                key.asymmetric = std::make_unique<const AsymmetricJwtKey>(config.key_pem);
+            } catch (const std::invalid_argument& e) {
+                throw std::invalid_argument(fmt::format("JWT key '{}': {}", config.kid, e.what()));
+            }
+            if (key.asymmetric->Alg() != config.alg) {
+                throw std::invalid_argument(fmt::format("JWT key '{}' is declared {} but the PEM is a {} key",
+                                                        config.kid, config.alg, key.asymmetric->Alg()));
+            }
+        } else {
+            throw std::invalid_argument(fmt::format("JWT key '{}' has unsupported alg '{}'", config.kid, config.alg));
+        }
+        key.alg = config.alg;
+        key.header_b64 = MakeHeaderB64(key.alg, config.kid);
+        return key;
+    }
+}
+
+std::string JwtKeySet::Key::Sign(const std::string_view signing_input) const {
+    if (hmac) {
+        const auto mac = hmac->Sign({signing_input});
+        return {reinterpret_cast<const char*>(mac.data()), mac.size()};
+    }
+    return asymmetric->Sign(signing_input);
+}
+
+bool JwtKeySet::Key::Verify(const std::string_view signing_input, const std::string_view signature) const {
+    return hmac ? hmac->Verify({signing_input}, signature) : asymmetric->Verify(signing_input, signature);
+}
+
+JwtKeySet::JwtKeySet(const std::string_view legacy_secret, const std::vector<JwtKey>& keys, std::string active_kid)
+    : active_kid_(std::move(active_kid)) {
+    if (!legacy_secret.empty()) {
+        legacy_ = std::make_unique<Key>(MakeKey(JwtKey{"", std::string(legacy_secret), "HS256", ""}));
+    }
+    jwks_ = "{\"keys\":[";
+    bool first_jwk = true;
+    for (const auto& key_config : keys) {
+        if (key_config.kid.empty()) {
+            throw std::invalid_argument("JWT key with empty kid");
+        }
+        const auto [it, inserted] = keys_.try_emplace(key_config.kid, MakeKey(key_config));
+        if (!inserted) {
+            throw std::invalid_argument(fmt::format("Duplicate JWT kid '{}'", key_config.kid));
+        }
+        if (it->second.asymmetric) {
+            if (!first_jwk) jwks_.push_back(',');
+            first_jwk = false;
+            AppendJwk(jwks_, key_config.kid, *it->second.asymmetric);
+        }
+    }
+    jwks_ += "]}";
+
+    signing_ = Find(active_kid_);
+    if (signing_ == nullptr) {
+        throw std::invalid_argument(active_kid_.empty() ? "No JWT signing key: legacy secret is empty"
+                                                        : fmt::format("Unknown active JWT kid '{}'", active_kid_));
+    }
+    if (!signing_->CanSign()) {
+        throw std::invalid_argument(fmt::format("Active JWT kid '{}' has no private key", active_kid_));
+    }
+}
+
+const JwtKeySet::Key* JwtKeySet::Find(const std::string_view kid) const {
+    if (kid.empty()) {
+        return legacy_.get();
+    }
+    const auto it = keys_.find(kid);
+    return it == keys_.end() ? nullptr : &it->second;
+}
+
+JwtCodec::JwtCodec(std::shared_ptr<const JwtKeySet> keys, std::string issuer)
+    : keys_(std::move(keys)), issuer_(std::move(issuer)) {
+}
+
+void JwtCodec::ReplaceKeys(std::shared_ptr<const JwtKeySet> keys) {
+    keys_.store(std::move(keys));
+}
+
+std::string JwtCodec::Sign(const std::string_view user_id, const std::chrono::system_clock::time_point issued_at,
+                           const std::chrono::system_clock::time_point expires_at) const {
+    // 与 jwt-cpp (picojson) 的输出一致：key 按字典序
+    std::string payload;
+    payload.reserve(64 + issuer_.size() + user_id.size());
+    payload += "{\"exp\":";
+    payload += std::to_string(ToNumericDate(expires_at));
+    payload += ",\"iat\":";
+    payload += std::to_string(ToNumericDate(issued_at));
+    payload += ",\"iss\":";
+    AppendJsonString(payload, issuer_);
+    payload += ",\"user_id\":";
+    AppendJsonString(payload, user_id);
+    payload.push_back('}');
+
+    const auto keys = keys_.load();
+    const auto& key = keys->Signing();
+    std::string token;
+    token.reserve(key.header_b64.size() + payload.size() * 4 / 3 + 96);
+    token += key.header_b64;
+    token.push_back('.');
+    Base64UrlEncode(payload, token);
+
+    const auto signature = key.Sign(token);
+    token.push_back('.');
+    Base64UrlEncode(signature, token);
+    return token;
+}
+
+std::expected<JwtClaims, JwtError> JwtCodec::Verify(const std::string_view token) const {
+    // 1. 结构：header.payload.signature
+    const auto dot1 = token.find('.');
+    const auto dot2 = dot1 == std::string_view::npos ? std::string_view::npos : token.find('.', dot1 + 1);
+    if (dot2 == std::string_view::npos || token.find('.', dot2 + 1) != std::string_view::npos) {
+        return std::unexpected(JwtError::FormatInvalid);
+    }
+    const auto header_b64 = token.substr(0, dot1);
+    const auto payload_b64 = token.substr(dot1 + 1, dot2 - dot1 - 1);
+    const auto signature_b64 = token.substr(dot2 + 1);
+
+    // 2. header：按 kid 选密钥，alg 必须与该密钥一致。header 尚未经过认证，只做有界的解码和扫描
+    char header[kMaxHeaderBytes];
+    const auto header_len = Base64UrlDecode(header_b64, header, sizeof(header));
+    if (!header_len) {
+        return std::unexpected(JwtError::FormatInvalid);
+    }
+    std::string alg;
+    std::string kid;
+    bool has_alg = false;
+    bool has_kid = false;
+    JsonScanner header_scanner({header, *header_len});
+    // 重复的成员一律按格式错误拒绝，不同实现对重复成员取值不一致
+    if (!header_scanner.ScanObject([&](const std::string& key, JsonScanner& s) {
+            if (key == "kid") return !std::exchange(has_kid, true) && s.ReadString(kid);
+            if (key == "alg") return !std::exchange(has_alg, true) && s.ReadString(alg);
+            return s.SkipValue();
+        })) {
+        return std::unexpected(JwtError::FormatInvalid);
+    }
+    // 快照在本次校验期间保持有效，热加载不会替换掉正在使用的密钥
+    const auto keys = keys_.load();
+    const auto* key = keys->Find(kid);
+    if (key == nullptr) {
+        SPDLOG_DEBUG("Unknown JWT kid: {}", kid);
+        return std::unexpected(JwtError::SignatureInvalid);
+    }
+    if (alg != key->alg) {
+        SPDLOG_DEBUG("JWT alg '{}' does not match key '{}'", alg, kid);
+        return std::unexpected(JwtError::FormatInvalid);
+    }
+
+    // 3. 签名：先于 payload 解析，伪造的令牌在这里就被拒绝
+    char signature[kMaxSignatureBytes + 1];
+    const auto signature_len = Base64UrlDecode(signature_b64, signature, sizeof(signature));
+    if (!signature_len || !key->Verify(token.substr(0, dot2), {signature, *signature_len})) {
+        SPDLOG_DEBUG("JWT signature mismatch");
+        return std::unexpected(JwtError::SignatureInvalid);
+    }
+
+    // 4. payload 只取 iss / exp / user_id
+    char payload[kMaxPayloadBytes];
+    const auto payload_len = Base64UrlDecode(payload_b64, payload, sizeof(payload));
+    if (!payload_len) {
+        return std::unexpected(JwtError::FormatInvalid);
+    }
+    std::string issuer;
+    std::optional<int64_t> exp;
+    JwtClaims claims{{}, std::chrono::system_clock::time_point::max()};
+    bool has_issuer = false;
+    bool has_user_id = false;
+    JsonScanner payload_scanner({payload, *payload_len});
+    const bool parsed = payload_scanner.ScanObject([&](const std::string& key, JsonScanner& s) {
+        if (key == "iss") {
+            return !std::exchange(has_issuer, true) && s.ReadString(issuer);
+        }
+        if (key == "exp") {
+            int64_t value = 0;
+            if (exp.has_value() || !s.ReadInt64(value)) return false;
+            exp = value;
+            return true;
+        }
+        if (key == "user_id") {
+            return !std::exchange(has_user_id, true) && s.ReadString(claims.user_id);
+        }
+        return s.SkipValue();
+    });
+    if (!parsed) {
+        return std::unexpected(JwtError::FormatInvalid);
+    }
+    if (!has_issuer || issuer != issuer_) {
+        SPDLOG_WARN("JWT issuer mismatch");
+        return std::unexpected(JwtError::SignatureInvalid);
+    }
+    if (exp.has_value()) {
+        claims.expires_at = std::chrono::system_clock::time_point(std::chrono::seconds(exp.value()));
+        if (std::chrono::system_clock::now() > claims.expires_at) {
+            SPDLOG_DEBUG("TokenExpired");
+            return std::unexpected(JwtError::TokenExpired);
+        }
+    }
+    if (!has_user_id) {
+        SPDLOG_WARN("Token valid but missing claim: user_id");
+        return std::unexpected(JwtError::FormatInvalid);
+    }
+    return claims;
+}
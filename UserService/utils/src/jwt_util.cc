@@ -1,73 +1,85 @@
 // Copyright (c) 2025 seaStarLxy.
 // Licensed under the MIT License.
 
-#undef JWT_DISABLE_PICOJSON
 #include "utils/include/jwt_util.h"
-#include <jwt-cpp/jwt.h>
 #include <chrono>
 #include <spdlog/spdlog.h>
 
 using namespace user_service::util;
 
 JwtUtil::JwtUtil(const JwtConfig& config)
-    : secret_key_(config.secret_key)
-    , issuer_(config.issuer)
-    , expiration_seconds_(config.expiration_seconds) {
-    SPDLOG_DEBUG("JwtUtil initialized. Issuer: {}, Expiry: {}s", issuer_, expiration_seconds_.count());
+    : issuer_(config.issuer)
+    , expiration_seconds_(config.expiration_seconds)
+    , codec_(MakeKeySet(config), config.issuer)
+    , verify_cache_(config.verify_cache) {
+    SPDLOG_DEBUG("JwtUtil initialized. Issuer: {}, Expiry: {}s, Keys: {}, ActiveKid: '{}'",
+        issuer_, expiration_seconds_.count(), config.keys.size(), config.active_kid);
 }
 
-JwtUtil::~JwtUtil() = default;
+JwtUtil::~JwtUtil() {
+    if (verify_cache_.Enabled()) {
+        const auto stats = verify_cache_.GetStats();
+        SPDLOG_INFO("JWT verify cache stats. Hits: {}, Misses: {}, Evictions: {}, Expirations: {}, Size: {}",
+            stats.hits, stats.misses, stats.evictions, stats.expirations, stats.size);
+    }
+}
+
+std::shared_ptr<const JwtKeySet> JwtUtil::MakeKeySet(const JwtConfig& config) {
+    return std::make_shared<const JwtKeySet>(config.secret_key, config.keys, config.active_kid);
+}
+
+void JwtUtil::ReloadKeys(const JwtConfig& config) {
+    // 先构造，失败时直接抛出，不影响正在使用的密钥
+    auto keys = MakeKeySet(config);
+    codec_.ReplaceKeys(std::move(keys));
+    key_generation_.fetch_add(1, std::memory_order_release);
+    SPDLOG_INFO("JWT keys reloaded. Keys: {}, ActiveKid: '{}'", config.keys.size(), config.active_kid);
+}
 
 std::string JwtUtil::GenerateToken(const std::string& user_id) {
     const auto now = std::chrono::system_clock::now();
+    return codec_.Sign(user_id, now, now + expiration_seconds_);
+}
 
-    return jwt::create()
-        .set_issuer(issuer_)
-        .set_type(TOKEN_TYPE)
-        .set_payload_claim(CLAIM_USER_ID, picojson::value(user_id))
-        .set_issued_at(now)
-        .set_expires_at(now + expiration_seconds_)
-        .sign(jwt::algorithm::hs256{secret_key_});
+std::string JwtUtil::GetJwks() {
+    return codec_.Keys()->Jwks();
 }
 
 std::expected<std::string, JwtError> JwtUtil::VerifyToken(const std::string& token) {
-    try {
-        const auto decoded = jwt::decode(token);
-
-        // 检查是否过期
-        if (decoded.has_expires_at()) {
-            if (std::chrono::system_clock::now() > decoded.get_expires_at()) {
-                SPDLOG_DEBUG("TokenExpired");
-                return std::unexpected(JwtError::TokenExpired);
-            }
-        }
-
-        // 验证签名和 Issuer
-        const auto verifier = jwt::verify()
-            .allow_algorithm(jwt::algorithm::hs256{secret_key_})
-            .with_issuer(issuer_);
-
-        verifier.verify(decoded);
+    return VerifyToken(std::string_view(token));
+}
 
-        // 提取 user_id
-        if (decoded.has_payload_claim(CLAIM_USER_ID)) {
-            return decoded.get_payload_claim(CLAIM_USER_ID).as_string();
+std::expected<std::string, JwtError> JwtUtil::VerifyToken(const std::string_view token) {
+    const uint64_t key = std::hash<std::string_view>{}(token);
+    const uint64_t generation = key_generation_.load(std::memory_order_acquire);
+    if (const auto cached = verify_cache_.Get(key);
+        cached.has_value() && cached.value()->key_generation == generation && cached.value()->token == token) {
+        const auto& verified = *cached.value();
+        if (std::chrono::system_clock::now() <= verified.expires_at) {
+            return verified.user_id;
         }
+        // 签名早已验证过，只是过期了
+        verify_cache_.Erase(key);
+        SPDLOG_DEBUG("TokenExpired");
+        return std::unexpected(JwtError::TokenExpired);
+    }
 
-        SPDLOG_WARN("Token valid but missing claim: {}", CLAIM_USER_ID);
-        return std::unexpected(JwtError::FormatInvalid);
-
-    } catch (const std::exception& e) {
-        SPDLOG_WARN("JWT Verification Exception: {}", e.what());
-        return std::unexpected(JwtError::SignatureInvalid);
+    // 代数在校验前读取：校验期间发生热加载时，条目带着旧代数写入，下次访问会重新校验
+    auto verified = VerifyTokenUncached(token, generation);
+    if (!verified.has_value()) {
+        return std::unexpected(verified.error());
     }
+    std::string user_id = verified.value()->user_id;
+    verify_cache_.Put(key, std::move(verified.value()));
+    return user_id;
 }
 
-std::expected<std::string, JwtError> JwtUtil::VerifyToken(const std::string_view token) {
-    /*
-     * 由于当下的 jwt-cpp 库限制，进行解码需要传入字符串，所以直接调用 std::string 接口，
-     * 但考虑到这里的作为拦截器，性能上应该追求极致，
-     * 理论上未来可以替换成直接解析 std::string_view 的 JWT 库，所以预留此接口
-     */
-    return VerifyToken(std::string(token));
-}
\ No newline at end of file
+std::expected<std::shared_ptr<const JwtUtil::VerifiedToken>, JwtError> JwtUtil::VerifyTokenUncached(
+    const std::string_view token, const uint64_t key_generation) const {
+    auto claims = codec_.Verify(token);
+    if (!claims.has_value()) {
+        return std::unexpected(claims.error());
+    }
+    return std::make_shared<const VerifiedToken>(VerifiedToken{
+        std::string(token), std::move(claims->user_id), claims->expires_at, key_generation});
+}
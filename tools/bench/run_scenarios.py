@@ -0,0 +1,484 @@
+# 端到端场景压测
+#
+# 在本机拉起独立的 Redis / PostgreSQL 进程 (临时目录，用完即删)，用 init_sql/ 建表并灌入测试用户和验证码，
+# 以生成的配置启动 UserServiceServer，再用 ghz 依次跑各个场景，结果写成 JSON，便于不同提交之间对比。
+#
+# 依赖：redis-server、PostgreSQL (initdb/pg_ctl/psql)、ghz 在 PATH 中 (或用参数指定)，Python 需要 PyYAML
+#
+# 用法：
+#   python3 tools/bench/run_scenarios.py run --server UserService/build/UserServiceServer
+#   python3 tools/bench/run_scenarios.py run --scenarios read_heavy,cold_cache --users 20000
+#   python3 tools/bench/run_scenarios.py compare base.json head.json --max-regression 10
+
+import argparse
+import base64
+import datetime
+import hashlib
+import hmac
+import json
+import os
+import platform
+import secrets
+import shutil
+import socket
+import subprocess
+import sys
+import tempfile
+import time
+import uuid
+
+try:
+    import yaml
+except ImportError:
+    sys.exit("PyYAML is required: pip install pyyaml")
+
+REPO_ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), '..', '..'))
+SERVICE_DIR = os.path.join(REPO_ROOT, 'UserService')
+PROTO_FILE = 'UserService/v1/user_service.proto'
+PROTO_PACKAGE = 'user_service.proto.v1'
+
+# 种子数据：所有用户共用一个密码，验证码固定，便于构造请求
+SEED_PASSWORD = 'bench-password-123'
+SEED_CODE = '123456'
+LOGIN_PHONE_BASE = 13000000000
+REGISTER_PHONE_BASE = 15000000000
+
+# 与 VerificationCodeRepository::GetKeyPrefixForUsage 一致
+CODE_KEY_PREFIX = {
+    'login': 'verify_code:login:',
+    'register': 'verify_code:register:',
+}
+
+
+# ============
+#  工具函数
+# ============
+
+def log(msg):
+    print(f"[bench] {msg}", flush=True)
+
+
+def free_port():
+    with socket.socket() as s:
+        s.bind(('127.0.0.1', 0))
+        return s.getsockname()[1]
+
+
+def wait_port(port, timeout, proc=None):
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        if proc is not None and proc.poll() is not None:
+            raise RuntimeError(f"process exited with code {proc.returncode} before listening on {port}")
+        try:
+            with socket.create_connection(('127.0.0.1', port), timeout=0.5):
+                return
+        except OSError:
+            time.sleep(0.1)
+    raise RuntimeError(f"port {port} not ready after {timeout}s")
+
+
+def find_binary(name, explicit_dir=None):
+    if explicit_dir:
+        path = os.path.join(explicit_dir, name)
+        if os.access(path, os.X_OK):
+            return path
+    path = shutil.which(name)
+    if path is None:
+        raise RuntimeError(f"'{name}' not found in PATH")
+    return path
+
+
+def git_commit():
+    try:
+        return subprocess.check_output(['git', 'rev-parse', '--short', 'HEAD'], cwd=REPO_ROOT, text=True).strip()
+    except (OSError, subprocess.CalledProcessError):
+        return 'unknown'
+
+
+def hash_password(password, salt):
+    # 与 SecurityUtil::HashPassword 一致：SHA256(password + salt)，CryptoPP HexEncoder 输出大写
+    return hashlib.sha256((password + salt).encode()).hexdigest().upper()
+
+
+def b64url(data):
+    return base64.urlsafe_b64encode(data).rstrip(b'=').decode()
+
+
+def make_token(user_id, jwt_config):
+    # 与 JwtUtil::GenerateToken 一致的 HS256 令牌
+    now = int(time.time())
+    header = {'alg': 'HS256', 'typ': 'JWS'}
+    payload = {
+        'iss': jwt_config['issuer'],
+        'user_id': user_id,
+        'iat': now,
+        'exp': now + int(jwt_config['expiration_seconds']),
+    }
+    signing_input = b64url(json.dumps(header, separators=(',', ':')).encode()) + '.' + \
+        b64url(json.dumps(payload, separators=(',', ':')).encode())
+    signature = hmac.new(jwt_config['secret_key'].encode(), signing_input.encode(), hashlib.sha256).digest()
+    return signing_input + '.' + b64url(signature)
+
+
+def resp_command(*args):
+    # RESP 编码，供 redis-cli --pipe 批量写入
+    out = [f"*{len(args)}\r\n"]
+    for arg in args:
+        arg = str(arg)
+        out.append(f"${len(arg.encode())}\r\n{arg}\r\n")
+    return ''.join(out)
+
+
+# ============
+#  依赖进程
+# ============
+
+class RedisProcess:
+    def __init__(self, work_dir, bin_dir):
+        self.port = free_port()
+        self.server_bin = find_binary('redis-server', bin_dir)
+        self.cli_bin = find_binary('redis-cli', bin_dir)
+        self.dir = os.path.join(work_dir, 'redis')
+        os.makedirs(self.dir)
+        self.proc = None
+
+    def start(self):
+        # 关闭持久化，测量只和内存操作相关
+        self.proc = subprocess.Popen(
+            [self.server_bin, '--port', str(self.port), '--bind', '127.0.0.1', '--save', '', '--appendonly', 'no',
+             '--dir', self.dir],
+            stdout=subprocess.DEVNULL, stderr=subprocess.STDOUT)
+        wait_port(self.port, 10, self.proc)
+        log(f"redis listening on {self.port}")
+
+    def pipe(self, payload):
+        subprocess.run([self.cli_bin, '-p', str(self.port), '--pipe'], input=payload.encode(), check=True,
+                       stdout=subprocess.DEVNULL)
+
+    def flushall(self):
+        subprocess.run([self.cli_bin, '-p', str(self.port), 'FLUSHALL'], check=True, stdout=subprocess.DEVNULL)
+
+    def stop(self):
+        if self.proc and self.proc.poll() is None:
+            self.proc.terminate()
+            self.proc.wait(timeout=10)
+
+
+class PostgresProcess:
+    USER = 'bench'
+    DB = 'bench_db'
+
+    def __init__(self, work_dir, bin_dir):
+        self.port = free_port()
+        self.initdb = find_binary('initdb', bin_dir)
+        self.pg_ctl = find_binary('pg_ctl', bin_dir)
+        self.psql = find_binary('psql', bin_dir)
+        self.data_dir = os.path.join(work_dir, 'pgdata')
+        self.socket_dir = os.path.join(work_dir, 'pgsock')
+        os.makedirs(self.socket_dir)
+        self.started = False
+
+    def start(self):
+        subprocess.run([self.initdb, '-D', self.data_dir, '-U', self.USER, '--auth=trust', '-E', 'UTF8'],
+                       check=True, stdout=subprocess.DEVNULL)
+        # 压测用途：关闭 fsync，避免测成磁盘性能
+        options = f"-p {self.port} -k {self.socket_dir} -c listen_addresses=127.0.0.1 -c fsync=off " \
+                  f"-c synchronous_commit=off -c max_connections=300"
+        subprocess.run([self.pg_ctl, '-D', self.data_dir, '-o', options, '-l', os.path.join(self.data_dir, 'pg.log'),
+                        '-w', 'start'], check=True, stdout=subprocess.DEVNULL)
+        self.started = True
+        self.run_sql(f"CREATE DATABASE {self.DB};", db='postgres')
+        log(f"postgres listening on {self.port}")
+
+    def run_sql(self, sql, db=None):
+        subprocess.run([self.psql, '-h', '127.0.0.1', '-p', str(self.port), '-U', self.USER, '-d', db or self.DB,
+                        '-v', 'ON_ERROR_STOP=1', '-q'], input=sql.encode(), check=True, stdout=subprocess.DEVNULL)
+
+    def load_schema(self):
+        # users 必须先于 user_login_logs (外键)
+        for name in ('init_users.sql', 'init_user_logs.sql'):
+            with open(os.path.join(SERVICE_DIR, 'init_sql', name), encoding='utf-8') as f:
+                self.run_sql(f.read())
+
+    def stop(self):
+        if self.started:
+            subprocess.run([self.pg_ctl, '-D', self.data_dir, '-m', 'fast', 'stop'], stdout=subprocess.DEVNULL)
+
+
+class ServerProcess:
+    def __init__(self, binary, work_dir, config):
+        self.binary = os.path.abspath(binary)
+        self.dir = os.path.join(work_dir, 'server')
+        self.config = config
+        self.port = config['server']['port']
+        self.proc = None
+
+    def start(self):
+        # 程序从工作目录下的 config/config.yaml 读取配置
+        os.makedirs(os.path.join(self.dir, 'config'), exist_ok=True)
+        with open(os.path.join(self.dir, 'config', 'config.yaml'), 'w', encoding='utf-8') as f:
+            yaml.safe_dump(self.config, f, allow_unicode=True, sort_keys=False)
+        self.log_file = open(os.path.join(self.dir, 'server.log'), 'ab')
+        self.proc = subprocess.Popen([self.binary], cwd=self.dir, stdout=self.log_file, stderr=subprocess.STDOUT)
+        wait_port(self.port, 30, self.proc)
+        log(f"UserServiceServer listening on {self.port} (pid {self.proc.pid})")
+
+    def stop(self):
+        if self.proc and self.proc.poll() is None:
+            self.proc.terminate()
+            try:
+                self.proc.wait(timeout=20)
+            except subprocess.TimeoutExpired:
+                self.proc.kill()
+                self.proc.wait()
+        if self.proc:
+            self.log_file.close()
+
+    def restart(self):
+        self.stop()
+        self.start()
+
+
+# ============
+#  种子数据
+# ============
+
+def seed_users(pg, count):
+    """灌入 count 个用户，返回 [(user_id, phone)]"""
+    users = []
+    rows = []
+    for i in range(count):
+        user_id = str(uuid.uuid4())
+        phone = str(LOGIN_PHONE_BASE + i)
+        salt = secrets.token_hex(16).upper()
+        users.append((user_id, phone))
+        rows.append(f"{user_id}\t{phone}\tbench_user_{i}\tbench_{i}@example.com\t"
+                    f"{hash_password(SEED_PASSWORD, salt)}\t{salt}\thttps://example.com/avatar/{i}.png")
+    sql = "COPY users (id, phone_number, username, email, password_hash, salt, avatar_url) FROM STDIN;\n" + \
+          '\n'.join(rows) + "\n\\.\n"
+    pg.run_sql(sql)
+    log(f"seeded {count} users")
+    return users
+
+
+def seed_codes(redis, phones, usage):
+    payload = ''.join(resp_command('SET', CODE_KEY_PREFIX[usage] + phone, SEED_CODE, 'EX', 24 * 3600)
+                      for phone in phones)
+    redis.pipe(payload)
+    log(f"seeded {len(phones)} {usage} codes")
+
+
+# ============
+#  场景
+# ============
+
+class Scenario:
+    def __init__(self, name, description, call, data, metadata=None, total=None, warmup=False, cold=False):
+        self.name = name
+        self.description = description
+        self.call = call
+        self.data = data
+        self.metadata = metadata
+        # None 表示使用全局 --requests
+        self.total = total
+        # 正式测量前先跑一轮同样的请求，预热缓存
+        self.warmup = warmup
+        # 清空 Redis 并重启服务 (清空进程内缓存) 后再测
+        self.cold = cold
+
+
+def build_scenarios(users, register_phones, jwt_config):
+    tokens = [{'authorization': f"Bearer {make_token(user_id, jwt_config)}"} for user_id, _ in users]
+    service = f"{PROTO_PACKAGE}.UserService"
+    auth = f"{PROTO_PACKAGE}.AuthService"
+    return {
+        'read_heavy': Scenario(
+            'read_heavy', 'GetUserInfo with warm caches, one token per seeded user',
+            f"{service}.GetUserInfo", [{}], metadata=tokens, warmup=True),
+        'login_storm': Scenario(
+            'login_storm', 'LoginByPassword over all seeded users (SHA256 verify + JWT sign)',
+            f"{auth}.LoginByPassword", [{'user_id': user_id, 'password': SEED_PASSWORD} for user_id, _ in users]),
+        'registration_burst': Scenario(
+            'registration_burst', 'Register unique phones with pre-seeded codes (DB insert path)',
+            f"{service}.Register",
+            [{'username': f"new_user_{i}", 'password': SEED_PASSWORD, 'phone_number': phone, 'code': SEED_CODE}
+             for i, phone in enumerate(register_phones)],
+            total=len(register_phones)),
+        'cold_cache': Scenario(
+            'cold_cache', 'GetUserInfo right after FLUSHALL and restart, each user touched once',
+            f"{service}.GetUserInfo", [{}], metadata=tokens, total=len(users), cold=True),
+    }
+
+
+def run_ghz(args, scenario, port, work_dir, total):
+    data_file = os.path.join(work_dir, f"{scenario.name}.data.json")
+    with open(data_file, 'w', encoding='utf-8') as f:
+        json.dump(scenario.data, f)
+    # 数组形式的 data / metadata 按请求轮流使用
+    cmd = [args.ghz, '--insecure', '--proto', os.path.join(args.idl_dir, PROTO_FILE),
+           '--import-paths', f"{args.idl_dir},{args.googleapis_dir}",
+           '--call', scenario.call, '--data-file', data_file,
+           '-c', str(args.concurrency), '--connections', str(args.connections),
+           '-n', str(total), '--format', 'json', f"127.0.0.1:{port}"]
+    if scenario.metadata is not None:
+        metadata_file = os.path.join(work_dir, f"{scenario.name}.metadata.json")
+        with open(metadata_file, 'w', encoding='utf-8') as f:
+            json.dump(scenario.metadata, f)
+        cmd[cmd.index('--data-file'):cmd.index('--data-file')] = ['--metadata-file', metadata_file]
+    out = subprocess.run(cmd, check=True, capture_output=True, text=True)
+    return json.loads(out.stdout)
+
+
+def summarize(report):
+    # 只保留便于对比的字段，延迟统一为毫秒
+    ns_to_ms = 1e-6
+    percentiles = {f"p{int(p['percentage'])}": p['latency'] * ns_to_ms
+                   for p in report.get('latencyDistribution') or []}
+    status = report.get('statusCodeDistribution') or {}
+    return {
+        'count': report.get('count', 0),
+        'rps': report.get('rps', 0.0),
+        'average_ms': report.get('average', 0) * ns_to_ms,
+        'fastest_ms': report.get('fastest', 0) * ns_to_ms,
+        'slowest_ms': report.get('slowest', 0) * ns_to_ms,
+        'latency_ms': percentiles,
+        'status': status,
+        'errors': sum(v for k, v in status.items() if k != 'OK'),
+        'error_samples': list((report.get('errorDistribution') or {}).keys())[:5],
+    }
+
+
+def cmd_run(args):
+    selected = [name.strip() for name in args.scenarios.split(',') if name.strip()]
+    with open(os.path.join(SERVICE_DIR, 'config', 'config.yaml'), encoding='utf-8') as f:
+        base_config = yaml.safe_load(f)
+
+    work_dir = tempfile.mkdtemp(prefix='photon-bench-')
+    redis = RedisProcess(work_dir, args.redis_bin_dir)
+    pg = PostgresProcess(work_dir, args.pg_bin_dir)
+    server = None
+    try:
+        redis.start()
+        pg.start()
+        pg.load_schema()
+        users = seed_users(pg, args.users)
+        register_phones = [str(REGISTER_PHONE_BASE + i) for i in range(args.registrations)]
+        seed_codes(redis, [phone for _, phone in users], 'login')
+        seed_codes(redis, register_phones, 'register')
+
+        # 基于仓库配置，只替换依赖地址和端口
+        config = base_config
+        config['server']['port'] = free_port()
+        config['server']['bind_ip'] = '127.0.0.1'
+        config['redis'].update({'host': '127.0.0.1', 'port': redis.port, 'mode': 'standalone', 'replicas': []})
+        config['postgresql'].update({'host': '127.0.0.1', 'port': pg.port, 'user': pg.USER, 'password': '',
+                                     'dbname': pg.DB})
+        server = ServerProcess(args.server, work_dir, config)
+        server.start()
+
+        scenarios = build_scenarios(users, register_phones, config['jwt'])
+        results = {}
+        for name in selected:
+            if name not in scenarios:
+                raise RuntimeError(f"unknown scenario '{name}', available: {', '.join(scenarios)}")
+            scenario = scenarios[name]
+            total = scenario.total or args.requests
+            if scenario.cold:
+                redis.flushall()
+                # 验证码也被清掉了，后续场景还要用
+                seed_codes(redis, [phone for _, phone in users], 'login')
+                server.restart()
+            if scenario.warmup:
+                run_ghz(args, scenario, server.port, work_dir, min(total, len(users)))
+            log(f"running {name}: {total} requests, concurrency {args.concurrency}")
+            summary = summarize(run_ghz(args, scenario, server.port, work_dir, total))
+            summary['description'] = scenario.description
+            results[name] = summary
+            log(f"  {name}: {summary['rps']:.0f} rps, p99 {summary['latency_ms'].get('p99', 0):.2f} ms, "
+                f"errors {summary['errors']}")
+
+        output = {
+            'commit': git_commit(),
+            'timestamp': datetime.datetime.now(datetime.timezone.utc).isoformat(),
+            'host': {'machine': platform.machine(), 'cpus': os.cpu_count(), 'system': platform.platform()},
+            'params': {'users': args.users, 'registrations': args.registrations, 'requests': args.requests,
+                       'concurrency': args.concurrency, 'connections': args.connections},
+            'scenarios': results,
+        }
+        out_path = args.output or os.path.join(REPO_ROOT, 'perf_data', 'scenarios',
+                                               f"{time.strftime('%Y%m%d-%H%M%S')}-{output['commit']}.json")
+        os.makedirs(os.path.dirname(os.path.abspath(out_path)), exist_ok=True)
+        with open(out_path, 'w', encoding='utf-8') as f:
+            json.dump(output, f, indent=2)
+        log(f"results written to {out_path}")
+        return 1 if any(r['errors'] for r in results.values()) and args.fail_on_errors else 0
+    finally:
+        if server:
+            server.stop()
+        pg.stop()
+        redis.stop()
+        if args.keep_work_dir:
+            log(f"work dir kept at {work_dir}")
+        else:
+            shutil.rmtree(work_dir, ignore_errors=True)
+
+
+def cmd_compare(args):
+    """对比两次结果：吞吐下降或 p99 上升超过阈值 (百分比) 时返回非零"""
+    with open(args.base, encoding='utf-8') as f:
+        base = json.load(f)
+    with open(args.head, encoding='utf-8') as f:
+        head = json.load(f)
+    regressed = False
+    print(f"{'scenario':<20}{'rps base':>12}{'rps head':>12}{'Δ%':>8}{'p99 base':>12}{'p99 head':>12}{'Δ%':>8}")
+    for name, head_result in head['scenarios'].items():
+        base_result = base['scenarios'].get(name)
+        if base_result is None:
+            continue
+        rps_delta = (head_result['rps'] - base_result['rps']) / base_result['rps'] * 100 if base_result['rps'] else 0
+        base_p99 = base_result['latency_ms'].get('p99', 0)
+        head_p99 = head_result['latency_ms'].get('p99', 0)
+        p99_delta = (head_p99 - base_p99) / base_p99 * 100 if base_p99 else 0
+        flag = ''
+        if rps_delta < -args.max_regression or p99_delta > args.max_regression:
+            flag = '  <-- regression'
+            regressed = True
+        print(f"{name:<20}{base_result['rps']:>12.0f}{head_result['rps']:>12.0f}{rps_delta:>8.1f}"
+              f"{base_p99:>12.2f}{head_p99:>12.2f}{p99_delta:>8.1f}{flag}")
+    return 1 if regressed else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Photon-Commerce UserService scenario benchmarks')
+    sub = parser.add_subparsers(dest='command', required=True)
+
+    run = sub.add_parser('run', help='provision dependencies, start the server and run scenarios')
+    run.add_argument('--server', default=os.path.join(SERVICE_DIR, 'build', 'UserServiceServer'))
+    run.add_argument('--scenarios', default='read_heavy,login_storm,registration_burst,cold_cache')
+    run.add_argument('--users', type=int, default=10000, help='seeded users')
+    run.add_argument('--registrations', type=int, default=5000, help='phones available to registration_burst')
+    run.add_argument('--requests', type=int, default=100000, help='requests per scenario unless fixed by it')
+    run.add_argument('--concurrency', type=int, default=200)
+    run.add_argument('--connections', type=int, default=4)
+    run.add_argument('--ghz', default='ghz')
+    run.add_argument('--idl-dir', default=os.path.join(REPO_ROOT, 'IDL'))
+    run.add_argument('--googleapis-dir', default=os.path.join(REPO_ROOT, 'third_party', 'googleapis'))
+    run.add_argument('--redis-bin-dir', help='directory of redis-server/redis-cli, default PATH')
+    run.add_argument('--pg-bin-dir', help='directory of initdb/pg_ctl/psql, default PATH')
+    run.add_argument('--output', help='result file, default perf_data/scenarios/<time>-<commit>.json')
+    run.add_argument('--fail-on-errors', action='store_true', help='exit non-zero when any request failed')
+    run.add_argument('--keep-work-dir', action='store_true', help='keep data dirs and server.log for inspection')
+    run.set_defaults(func=cmd_run)
+
+    compare = sub.add_parser('compare', help='compare two result files')
+    compare.add_argument('base')
+    compare.add_argument('head')
+    compare.add_argument('--max-regression', type=float, default=10.0, help='allowed regression in percent')
+    compare.set_defaults(func=cmd_compare)
+
+    args = parser.parse_args()
+    sys.exit(args.func(args))
+
+
+if __name__ == '__main__':
+    main()